@@ -39,6 +39,14 @@ namespace CompileScore
         public uint Count { get; }
         public uint UnitCount { get; }
         public float Severity { set; get; }
+        public ulong AccumulatedError { set; get; } = 0; //heavy hitters mode: maximum overestimation of Accumulated
+        public ulong AccumulatedMargin { set; get; } = 0; //sampled mode: 95% confidence interval half width of Accumulated
+        public uint P50 { set; get; } = 0;
+        public uint P90 { set; get; } = 0;
+        public uint P99 { set; get; } = 0;
+        public ulong ExclusiveAccumulated { set; get; } = 0; //includes: time of the includes only reachable through this one
+        public ulong RebuildCost { set; get; } = 0; //includes: compilation time of all units including this one transitively
+        public uint RebuildUnitCount { set; get; } = 0; //includes: number of units including this one transitively
         public UnitValue MaxUnit { get; }
         public UnitValue SelfMaxUnit { get; }
     }
@@ -53,6 +61,7 @@ namespace CompileScore
 
         public CompilerData.CompileCategory Category { get; }
         public ulong  Total { set; get; }
+        public ulong  Margin { set; get; } = 0; //sampled mode: 95% confidence interval half width of Total
         public double Ratio 
         {
             set {}
@@ -93,6 +102,50 @@ namespace CompileScore
         public uint  Version { set; get; } = 0;
         public uint  TimelinePacking { set; get; } = 0; 
         public ulong FullDuration { set; get; } = 0;
+        public bool  Sampled { set; get; } = false;
+        public uint  SampledFiles { set; get; } = 0;
+        public uint  TotalFiles { set; get; } = 0;
+    }
+
+    public class CompileConcurrency
+    {
+        public uint Peak { set; get; } = 0;
+        public List<ulong> LevelDurations { set; get; } = new List<ulong>(); //time spent with each number of active units
+        public ulong SliceDuration { set; get; } = 0;
+        public List<ulong> SliceActivity { set; get; } = new List<ulong>(); //active unit time per slice
+        public ulong TailStart { set; get; } = 0;
+        public List<UnitValue> TailUnits { set; get; } = new List<UnitValue>(); //sorted by finish time
+
+        public double GetSliceConcurrency(int slice)
+        {
+            return SliceDuration > 0 && slice < SliceActivity.Count ? ((double)SliceActivity[slice]) / SliceDuration : 0;
+        }
+    }
+
+    public class BuildStep
+    {
+        public string Output { set; get; }
+        public ulong Start { set; get; } = 0;
+        public ulong End { set; get; } = 0;
+        public ulong Slack { set; get; } = 0; //delay allowed before this step delays the critical path
+        public UnitValue Unit { set; get; } = null; //null when the step is not a traced unit
+        public bool Critical { set; get; } = false;
+    }
+
+    public class CompileBuildLog
+    {
+        public List<BuildStep> Steps { set; get; } = new List<BuildStep>();
+        public List<BuildStep> CriticalPath { set; get; } = new List<BuildStep>(); //from the build start to its end
+    }
+
+    public class CompileScope
+    {
+        public string Name { set; get; }
+        public int Parent { set; get; } = -1;
+        public List<int> Children { set; get; } = new List<int>();
+        public ulong[] Accumulated { set; get; } = new ulong[(int)CompilerData.CompileThresholds.Gather]; //per symbol category of all the symbols inside this scope
+        public ulong[] SelfAccumulated { set; get; } = new ulong[(int)CompilerData.CompileThresholds.Gather];
+        public uint[] Count { set; get; } = new uint[(int)CompilerData.CompileThresholds.Gather];
     }
 
     public class CompileDataset
@@ -108,7 +161,11 @@ namespace CompileScore
         public static CompilerData Instance { get { return lazy.Value; } }
 
         public const uint VERSION_MIN = 9;
-        public const uint VERSION = 13;
+        public const uint VERSION = 22;
+
+        private const uint GLOBALS_FLAG_APPROXIMATE = 1u << 0;
+        private const uint GLOBALS_FLAG_SAMPLED = 1u << 1;
+        private const uint SESSION_FLAG_SAMPLED = 1u << 0;
 
         //Keep this in sync with the data exporter
         public enum CompileCategory
@@ -171,6 +228,8 @@ namespace CompileScore
         private List<UnitValue> UnitsCollection { set; get; } = new List<UnitValue>();
         private List<UnitTotal> Totals { set; get; } = new List<UnitTotal>();
         private CompileSession Session { set; get; } = new CompileSession();
+        private CompileConcurrency Concurrency { set; get; } = new CompileConcurrency();
+        private CompileBuildLog BuildLog { set; get; } = new CompileBuildLog();
 
         private uint HydrationFlags { set; get; } = 0;
         private uint LoadingFlags { set; get; } = 0;
@@ -184,12 +243,22 @@ namespace CompileScore
 
         private List<string> OtherTags { set; get; }
 
+        private List<CompileScope> Scopes { set; get; } = new List<CompileScope>();
+
+        private List<CompileValue> Passes { set; get; } = new List<CompileValue>();
+
+        private List<CompileValue> OtherValues { set; get; } = new List<CompileValue>();
+
+        public bool GlobalsApproximate { private set; get; } = false;
+
         //load structures 
 
         private class MainLoadChunk
         {
             public uint LoadingBatch { set; get; } = 0;
             public CompileSession Session { set; get; } = new CompileSession();
+            public CompileConcurrency Concurrency { set; get; } = new CompileConcurrency();
+            public CompileBuildLog BuildLog { set; get; } = new CompileBuildLog();
             public List<UnitTotal> Totals { set; get; } = new List<UnitTotal>();
             public List<UnitValue> Units { set; get; } = new List<UnitValue>();
             public CompileDataset[] Datasets { set; get; } = new CompileDataset[(int)CompileThresholds.Gather].Select(h => new CompileDataset()).ToArray();
@@ -202,6 +271,10 @@ namespace CompileScore
             public uint LoadingBatch { set; get; } = 0;
             public CompileDataset[] Datasets { set; get; } = new CompileDataset[(int)CompileThresholds.Gather].Select(h => new CompileDataset()).ToArray();
             public List<string> OtherTags { set; get; }
+            public List<CompileScope> Scopes { set; get; } = new List<CompileScope>();
+            public List<CompileValue> Passes { set; get; } = new List<CompileValue>();
+            public List<CompileValue> OtherValues { set; get; } = new List<CompileValue>();
+            public bool Approximate { set; get; } = false;
         }
 
         private bool _customTextHighlightEnabled = true;
@@ -268,6 +341,31 @@ namespace CompileScore
             return Session;
         }
 
+        public CompileConcurrency GetConcurrency()
+        {
+            return Concurrency;
+        }
+
+        public CompileBuildLog GetBuildLog()
+        {
+            return BuildLog;
+        }
+
+        public List<CompileScope> GetScopes()
+        {
+            return Scopes;
+        }
+
+        public List<CompileValue> GetPasses()
+        {
+            return Passes;
+        }
+
+        public List<CompileValue> GetOtherValues()
+        {
+            return OtherValues;
+        }
+
         public List<UnitTotal> GetTotals()
         {
             return Totals;
@@ -458,6 +556,140 @@ namespace CompileScore
                 //read deprecated Other total
                 reader.ReadUInt64(); 
             }
+
+            uint flags = version >= 15 ? reader.ReadUInt32() : 0;
+            session.Sampled = (flags & SESSION_FLAG_SAMPLED) != 0;
+
+            if (session.Sampled)
+            {
+                session.SampledFiles = reader.ReadUInt32();
+                session.TotalFiles = reader.ReadUInt32();
+                foreach (UnitTotal total in totals)
+                {
+                    total.Margin = reader.ReadUInt64();
+                }
+            }
+        }
+
+        private static void ReadConcurrency(BinaryReader reader, CompileConcurrency concurrency, List<UnitValue> units)
+        {
+            concurrency.Peak = reader.ReadUInt32();
+
+            uint levelsLength = reader.ReadUInt32();
+            for (uint i = 0; i < levelsLength; ++i)
+            {
+                concurrency.LevelDurations.Add(reader.ReadUInt64());
+            }
+
+            concurrency.SliceDuration = reader.ReadUInt64();
+            uint slicesLength = reader.ReadUInt32();
+            for (uint i = 0; i < slicesLength; ++i)
+            {
+                concurrency.SliceActivity.Add(reader.ReadUInt64());
+            }
+
+            concurrency.TailStart = reader.ReadUInt64();
+            uint tailLength = reader.ReadUInt32();
+            for (uint i = 0; i < tailLength; ++i)
+            {
+                UnitValue unit = GetUnitByIndex(reader.ReadUInt32(), units);
+                if (unit != null)
+                {
+                    concurrency.TailUnits.Add(unit);
+                }
+            }
+        }
+
+        private static void ReadBuildLog(BinaryReader reader, CompileBuildLog buildLog, List<UnitValue> units)
+        {
+            uint stepsLength = reader.ReadUInt32();
+            for (uint i = 0; i < stepsLength; ++i)
+            {
+                BuildStep step = new BuildStep();
+                step.Output = reader.ReadString();
+                step.Start = reader.ReadUInt64();
+                step.End = reader.ReadUInt64();
+                step.Slack = reader.ReadUInt64();
+                step.Unit = GetUnitByIndex(reader.ReadUInt32(), units);
+                step.Critical = reader.ReadByte() != 0;
+                buildLog.Steps.Add(step);
+            }
+
+            uint pathLength = reader.ReadUInt32();
+            for (uint i = 0; i < pathLength; ++i)
+            {
+                int stepIndex = (int)reader.ReadUInt32();
+                if (stepIndex < buildLog.Steps.Count)
+                {
+                    buildLog.CriticalPath.Add(buildLog.Steps[stepIndex]);
+                }
+            }
+        }
+
+        private static void ReadScopes(BinaryReader reader, List<CompileScope> scopes)
+        {
+            uint scopesLength = reader.ReadUInt32();
+            for (uint i = 0; i < scopesLength; ++i)
+            {
+                CompileScope scope = new CompileScope();
+                scope.Name = reader.ReadString();
+
+                uint childrenLength = reader.ReadUInt32();
+                for (uint k = 0; k < childrenLength; ++k)
+                {
+                    scope.Children.Add((int)reader.ReadUInt32());
+                }
+
+                for (int category = (int)CompileThresholds.Severity; category < (int)CompileThresholds.Gather; ++category)
+                {
+                    scope.Accumulated[category] = reader.ReadUInt64();
+                    scope.SelfAccumulated[category] = reader.ReadUInt64();
+                    scope.Count[category] = reader.ReadUInt32();
+                }
+
+                scopes.Add(scope);
+            }
+
+            for (int i = 0; i < scopes.Count; ++i)
+            {
+                foreach (int child in scopes[i].Children)
+                {
+                    if (child < scopes.Count)
+                    {
+                        scopes[child].Parent = i;
+                    }
+                }
+            }
+        }
+
+        private static void ReadAccumulatedMargins(BinaryReader reader, List<CompileValue> list)
+        {
+            uint marginsLength = reader.ReadUInt32();
+            for (int k = 0; k < marginsLength; ++k)
+            {
+                ulong margin = reader.ReadUInt64();
+                if (k < list.Count)
+                {
+                    list[k].AccumulatedMargin = margin;
+                }
+            }
+        }
+
+        private static void ReadIncludeCosts(BinaryReader reader, uint version, List<CompileValue> list)
+        {
+            uint costsLength = reader.ReadUInt32();
+            for (int k = 0; k < costsLength; ++k)
+            {
+                ulong exclusive = reader.ReadUInt64();
+                ulong rebuildCost = version >= 20 ? reader.ReadUInt64() : 0;
+                uint rebuildUnits = version >= 20 ? reader.ReadUInt32() : 0;
+                if (k < list.Count)
+                {
+                    list[k].ExclusiveAccumulated = exclusive;
+                    list[k].RebuildCost = rebuildCost;
+                    list[k].RebuildUnitCount = rebuildUnits;
+                }
+            }
         }
 
         private static void ReadCompileUnit(BinaryReader reader, uint version, List<UnitValue> list, uint index)
@@ -505,9 +737,27 @@ namespace CompileScore
             uint unitCount = (version >= 10) ? reader.ReadUInt32() : count;
 
             var compileData = new CompileValue(name, acc, selfAcc, unitAcc, min, max, selfMax, count, unitCount, maxUnit, selfMaxUnit);
+
+            if (version >= 16)
+            {
+                compileData.P50 = reader.ReadUInt32();
+                compileData.P90 = reader.ReadUInt32();
+                compileData.P99 = reader.ReadUInt32();
+            }
+
             list.Add(compileData);
         }
 
+        private static void ReadCompileValues(BinaryReader reader, uint version, List<CompileValue> list, List<UnitValue> units)
+        {
+            uint dataLength = reader.ReadUInt32();
+            list.Capacity = (int)dataLength;
+            for (uint k = 0; k < dataLength; ++k)
+            {
+                ReadCompileValue(reader, version, list, units);
+            }
+        }
+
         private static List<string> ReadOtherTags(BinaryReader reader, uint version )
         {
             if (version < 13) 
@@ -631,6 +881,11 @@ namespace CompileScore
                         // Read Session
                         ReadSession(reader, version, chunk.Session, chunk.Totals);
 
+                        if (chunk.Session.Sampled)
+                        {
+                            _ = OutputLog.LogGlobalAsync("Score file is sampled (" + chunk.Session.SampledFiles + " of " + chunk.Session.TotalFiles + " files), the totals are extrapolated");
+                        }
+
                         // Read Units 
                         uint unitsLength = reader.ReadUInt32();
                         chunk.Units = new List<UnitValue>((int)unitsLength);
@@ -662,6 +917,26 @@ namespace CompileScore
                             chunk.Includers = CompilerIncluders.ReadIncludersFromFile(fullPath + ".incl");
                         }
 
+                        if (chunk.Session.Sampled)
+                        {
+                            ReadAccumulatedMargins(reader, chunk.Datasets[(int)CompileCategory.Include].collection);
+                        }
+
+                        if (version >= 17)
+                        {
+                            ReadConcurrency(reader, chunk.Concurrency, chunk.Units);
+                        }
+
+                        if (version >= 18)
+                        {
+                            ReadBuildLog(reader, chunk.BuildLog, chunk.Units);
+                        }
+
+                        if (version >= 19)
+                        {
+                            ReadIncludeCosts(reader, version, chunk.Datasets[(int)CompileCategory.Include].collection);
+                        }
+
                     }
                 }
 
@@ -690,6 +965,10 @@ namespace CompileScore
                     uint version = reader.ReadUInt32();
                     if (CheckVersion(version))
                     {
+                        uint flags = version >= 14 ? reader.ReadUInt32() : 0;
+                        chunk.Approximate = (flags & GLOBALS_FLAG_APPROXIMATE) != 0;
+                        bool sampled = (flags & GLOBALS_FLAG_SAMPLED) != 0;
+
                         //Read Remaining Datasets
                         for (int i = (int)CompileThresholds.Severity; i < (int)CompileThresholds.Gather; ++i)
                         {
@@ -703,6 +982,45 @@ namespace CompileScore
                         }
 
                         chunk.OtherTags = ReadOtherTags(reader, version);
+
+                        if (chunk.Approximate)
+                        {
+                            //Read the heavy hitters error bounds
+                            for (int i = (int)CompileThresholds.Severity; i < (int)CompileThresholds.Gather; ++i)
+                            {
+                                List<CompileValue> thislist = chunk.Datasets[i].collection;
+                                uint errorsLength = reader.ReadUInt32();
+                                for (int k = 0; k < errorsLength; ++k)
+                                {
+                                    ulong error = reader.ReadUInt64();
+                                    if (k < thislist.Count)
+                                    {
+                                        thislist[k].AccumulatedError = error;
+                                    }
+                                }
+                            }
+                        }
+
+                        if (sampled)
+                        {
+                            //Read the sampling confidence intervals
+                            for (int i = (int)CompileThresholds.Severity; i < (int)CompileThresholds.Gather; ++i)
+                            {
+                                ReadAccumulatedMargins(reader, chunk.Datasets[i].collection);
+                            }
+                        }
+
+                        if (version >= 21)
+                        {
+                            ReadScopes(reader, chunk.Scopes);
+                        }
+
+                        if (version >= 22)
+                        {
+                            //Read the backend passes and the other tags timings
+                            ReadCompileValues(reader, version, chunk.Passes, Units);
+                            ReadCompileValues(reader, version, chunk.OtherValues, Units);
+                        }
                     }
                 }
 
@@ -718,6 +1036,8 @@ namespace CompileScore
         private void ApplyLoadChunk(MainLoadChunk chunk)
         {
             Session = chunk.Session;
+            Concurrency = chunk.Concurrency;
+            BuildLog = chunk.BuildLog;
             Totals = chunk.Totals; 
             UnitsCollection = chunk.Units;
             Datasets = chunk.Datasets;
@@ -745,6 +1065,10 @@ namespace CompileScore
             }
 
             OtherTags = chunk.OtherTags;
+            Scopes = chunk.Scopes;
+            Passes = chunk.Passes;
+            OtherValues = chunk.OtherValues;
+            GlobalsApproximate = chunk.Approximate;
         }
 
         private void LoadMainScore(string fullPath)
@@ -1,9 +1,11 @@
 #pragma once
 
 typedef unsigned char      U8;
+typedef unsigned short     U16;
 typedef unsigned int       U32;
 typedef unsigned long long U64;
 
 static_assert(sizeof(U8)  == 1,"wrong native type size");
+static_assert(sizeof(U16) == 2,"wrong native type size");
 static_assert(sizeof(U32) == 4,"wrong native type size");
 static_assert(sizeof(U64) == 8,"wrong native type size");
\ No newline at end of file
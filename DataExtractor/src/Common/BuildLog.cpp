@@ -0,0 +1,313 @@
+#include "BuildLog.h"
+
+#include <string.h>
+
+#include "../Common/CRC64.h"
+#include "../Common/ScoreDefinitions.h"
+#include "../Common/ScoreUtils.h"
+#include "../Common/StringUtils.h"
+#include "../fastl/algorithm.h"
+
+#include "IOStream.h"
+#include "Profiler.h"
+
+namespace BuildLog
+{
+	namespace Utils
+	{
+		constexpr const char* NINJA_LOG_HEADER = "# ninja log v";
+		constexpr U32 REPORT_MAX_SLACK_ENTRIES = 50u;
+
+		// -----------------------------------------------------------------------------------------------------------
+		const char* ParseU64(const char* str, U64& output)
+		{
+			output = 0u;
+			for (; *str >= '0' && *str <= '9'; ++str)
+			{
+				output = (output * 10u) + (*str - '0');
+			}
+			return str;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		const char* SkipField(const char* str)
+		{
+			while (*str != '\t' && *str != '\n' && *str != '\0') ++str;
+			return str;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// <start ms> \t <end ms> \t <mtime> \t <output> \t <command hash>
+		bool ParseNinjaLine(CompileBuildStep& step, const char* line)
+		{
+			U64 start = 0u;
+			U64 end = 0u;
+
+			line = ParseU64(line, start);
+			if (*line != '\t') return false;
+			line = ParseU64(line + 1, end);
+			if (*line != '\t') return false;
+			line = SkipField(line + 1);
+			if (*line != '\t') return false;
+
+			const char* outputStart = ++line;
+			line = SkipField(line);
+			const char* outputEnd = line;
+			while (outputEnd > outputStart && outputEnd[-1] == '\r') --outputEnd;
+			if (outputEnd == outputStart) return false;
+
+			step.output = fastl::string(outputStart, outputEnd - outputStart);
+			step.start  = start * 1000u;
+			step.end    = end > start ? end * 1000u : start * 1000u;
+			return true;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// Hash of the normalized path without the extension of its last component ( foo.cpp.o -> foo.cpp )
+		U64 GetPathHash(const fastl::string& path)
+		{
+			size_t length = path.length();
+			for (size_t i = length; i > 0u && path[i - 1] != '/'; --i)
+			{
+				if (path[i - 1] == '.')
+				{
+					length = i - 1;
+					break;
+				}
+			}
+			return Hash::AppendToCRC64(0ull, path.c_str(), length);
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// Traces are dumped next to the object files, the log outputs can be relative to the build folder while the unit names are relative to the input
+		void JoinUnits(ScoreData& scoreData)
+		{
+			TCompileBuildSteps& steps = scoreData.buildLog.steps;
+
+			TIndexDataDictionary outputs;
+			for (U32 i = 0u, sz = static_cast<U32>(steps.size()); i < sz; ++i)
+			{
+				outputs.insert(TIndexDataDictionary::value_type(GetPathHash(steps[i].output), i));
+			}
+
+			for (const CompileUnit& unit : scoreData.units)
+			{
+				TCompileStrings::const_iterator found = scoreData.strings.find(unit.nameHash);
+				if (found == scoreData.strings.end()) continue;
+
+				//try from the longest suffix to the shortest one
+				const fastl::string& name = found->second;
+				const size_t length = name.length();
+				for (size_t offset = 0u; offset < length;)
+				{
+					TIndexDataDictionary::const_iterator match = outputs.find(Hash::AppendToCRC64(0ull, name.c_str() + offset, length - offset));
+					if (match != outputs.end() && steps[match->second].unitId == InvalidCompileId)
+					{
+						steps[match->second].unitId = unit.unitId;
+						break;
+					}
+
+					while (offset < length && name[offset] != '/') ++offset;
+					++offset;
+				}
+			}
+		}
+
+		using ScoreUtils::ToMs;
+
+		// -----------------------------------------------------------------------------------------------------------
+		void AppendStep(IO::TextOutputStream& stream, const CompileBuildStep& step, const U64 value)
+		{
+			stream.AppendFormat("%14.1f %14.1f %14.1f  %c %s\n", ToMs(step.start), ToMs(step.end - step.start), ToMs(value), step.unitId == InvalidCompileId ? ' ' : 'U', step.output.c_str());
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool ReadNinjaLog(ScoreData& scoreData, const char* filename)
+	{
+		PROFILE_ZONE("ReadNinjaLog");
+
+		IO::FileTextBuffer buffer = IO::ReadTextFile(filename);
+		if (buffer == nullptr)
+		{
+			return false;
+		}
+
+		CompileBuildLog& buildLog = scoreData.buildLog;
+		buildLog = CompileBuildLog();
+
+		const size_t headerLength = strlen(Utils::NINJA_LOG_HEADER);
+		const bool valid = strncmp(buffer, Utils::NINJA_LOG_HEADER, headerLength) == 0;
+		if (!valid)
+		{
+			LOG_ERROR("Unknown build log format found in %s, only .ninja_log files are supported.", filename);
+		}
+		else
+		{
+			U64 lastEnd = 0u;
+			CompileBuildStep step;
+
+			for (const char* line = buffer; *line != '\0';)
+			{
+				if (*line != '#' && Utils::ParseNinjaLine(step, line))
+				{
+					//ninja appends each build to the same log, the timings restart with every new build
+					if (step.end < lastEnd)
+					{
+						buildLog.steps.clear();
+					}
+					lastEnd = step.end;
+
+					StringUtils::NormalizePath(step.output);
+					buildLog.steps.push_back(step);
+				}
+
+				while (*line != '\n' && *line != '\0') ++line;
+				if (*line == '\n') ++line;
+			}
+
+			LOG_INFO("Found %u steps in the build log %s", static_cast<U32>(buildLog.steps.size()), filename);
+		}
+
+		IO::DestroyBuffer(buffer);
+		return valid;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	void ComputeCriticalPath(ScoreData& scoreData)
+	{
+		PROFILE_ZONE("ComputeCriticalPath");
+
+		CompileBuildLog& buildLog = scoreData.buildLog;
+		TCompileBuildSteps& steps = buildLog.steps;
+		buildLog.criticalPath.clear();
+		buildLog.duration = 0u;
+
+		if (steps.empty())
+		{
+			return;
+		}
+
+		Utils::JoinUnits(scoreData);
+
+		//sort by end time, for equal ends the longest step goes last so it is found first when walking backwards
+		const U32 numSteps = static_cast<U32>(steps.size());
+		fastl::vector<U32> byEnd(numSteps);
+		for (U32 i = 0u; i < numSteps; ++i)
+		{
+			byEnd[i] = i;
+		}
+		fastl::sort(byEnd.begin(), byEnd.end(), [&](const U32 a, const U32 b) { return steps[a].end < steps[b].end || (steps[a].end == steps[b].end && steps[a].start > steps[b].start); });
+
+		//without dependency edges the predecessor of a step is the last one to finish before it started
+		U32 current = byEnd.back();
+		buildLog.duration = steps[current].end;
+
+		while (current != InvalidCompileId)
+		{
+			steps[current].critical = true;
+			buildLog.criticalPath.push_back(current);
+
+			const U64 start = steps[current].start;
+			fastl::vector<U32>::iterator it = fastl::lower_bound(byEnd.begin(), byEnd.end(), start, [&](const U32 id, const U64 value) { return steps[id].end <= value; });
+
+			current = InvalidCompileId;
+			while (it != byEnd.begin())
+			{
+				--it;
+				if (!steps[*it].critical)
+				{
+					current = *it;
+					break;
+				}
+			}
+		}
+
+		fastl::vector<U32>& path = buildLog.criticalPath;
+		for (size_t i = 0u, sz = path.size(); i < sz / 2; ++i)
+		{
+			const U32 swap = path[i];
+			path[i] = path[sz - 1 - i];
+			path[sz - 1 - i] = swap;
+		}
+
+		//slack: time until the next critical step starts ( or the build ends )
+		for (CompileBuildStep& step : steps)
+		{
+			if (step.critical)
+			{
+				step.slack = 0u;
+				continue;
+			}
+
+			fastl::vector<U32>::iterator next = fastl::lower_bound(path.begin(), path.end(), step.end, [&](const U32 id, const U64 value) { return steps[id].start < value; });
+			const U64 limit = next == path.end() ? buildLog.duration : steps[*next].start;
+			step.slack = limit > step.end ? limit - step.end : 0u;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool WriteReport(const ScoreData& scoreData, const char* filename)
+	{
+		PROFILE_ZONE("WriteBuildLogReport");
+
+		IO::TextOutputStream stream(filename);
+		if (!stream.IsValid())
+		{
+			LOG_ERROR("Unable to create the build log report %s", filename);
+			return false;
+		}
+
+		const CompileBuildLog& buildLog = scoreData.buildLog;
+		const TCompileBuildSteps& steps = buildLog.steps;
+
+		U32 numJoined = 0u;
+		for (const CompileBuildStep& step : steps)
+		{
+			numJoined += step.unitId == InvalidCompileId ? 0u : 1u;
+		}
+
+		U64 pathBusy = 0u;
+		U64 pathUnits = 0u;
+		for (const U32 stepId : buildLog.criticalPath)
+		{
+			const CompileBuildStep& step = steps[stepId];
+			pathBusy += step.end - step.start;
+			pathUnits += step.unitId == InvalidCompileId ? 0u : step.end - step.start;
+		}
+
+		stream.Append("Build Log Report\n================\n\n");
+		stream.AppendFormat("Build duration: %.1f ms\n", Utils::ToMs(buildLog.duration));
+		stream.AppendFormat("Steps: %u ( %u joined to units )\n", static_cast<U32>(steps.size()), numJoined);
+		stream.AppendFormat("Critical path: %u steps, %.1f ms busy ( %.1f ms on units ), %.1f ms idle\n", static_cast<U32>(buildLog.criticalPath.size()), Utils::ToMs(pathBusy), Utils::ToMs(pathUnits), Utils::ToMs(buildLog.duration > pathBusy ? buildLog.duration - pathBusy : 0u));
+		stream.Append("The log has no dependency edges, the path is inferred from the step timings.\n");
+
+		stream.Append("\nCritical Path\n\n");
+		stream.Append("     Start(ms)   Duration(ms)     Finish(ms)  U Output\n");
+		for (const U32 stepId : buildLog.criticalPath)
+		{
+			Utils::AppendStep(stream, steps[stepId], steps[stepId].end);
+		}
+
+		//units closest to becoming critical
+		fastl::vector<U32> candidates;
+		for (U32 i = 0u, sz = static_cast<U32>(steps.size()); i < sz; ++i)
+		{
+			if (!steps[i].critical && steps[i].unitId != InvalidCompileId)
+			{
+				candidates.push_back(i);
+			}
+		}
+		fastl::sort(candidates.begin(), candidates.end(), [&](const U32 a, const U32 b) { return steps[a].slack < steps[b].slack || (steps[a].slack == steps[b].slack && a < b); });
+
+		const U32 numCandidates = static_cast<U32>(candidates.size()) < Utils::REPORT_MAX_SLACK_ENTRIES ? static_cast<U32>(candidates.size()) : Utils::REPORT_MAX_SLACK_ENTRIES;
+		stream.AppendFormat("\nLowest Slack Units ( %u of %u )\n\n", numCandidates, static_cast<U32>(candidates.size()));
+		stream.Append("     Start(ms)   Duration(ms)      Slack(ms)  U Output\n");
+		for (U32 i = 0u; i < numCandidates; ++i)
+		{
+			Utils::AppendStep(stream, steps[candidates[i]], steps[candidates[i]].slack);
+		}
+
+		return true;
+	}
+}
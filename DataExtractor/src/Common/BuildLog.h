@@ -0,0 +1,13 @@
+#pragma once
+
+// Build system logs ( .ninja_log ) joined to the extracted units
+// The log has no dependency edges, the critical path is inferred from the step timings
+
+struct ScoreData;
+
+namespace BuildLog
+{
+	bool ReadNinjaLog(ScoreData& scoreData, const char* filename); //only keeps the last build found in the log
+	void ComputeCriticalPath(ScoreData& scoreData);
+	bool WriteReport(const ScoreData& scoreData, const char* filename);
+}
@@ -10,9 +10,17 @@ ExportParams::ExportParams()
     , detail(Detail::Full)
     , includers(Includers::Enabled)
     , templateArgs(TemplateArgs::Collapse)
+    , globals(Globals::Exact)
+    , globalsCapacity(0u)
+    , samplePercent(100u)
     , timeline(Timeline::Enabled)
     , timelineDetail(Detail::Full)
     , timelinePacking(100)
+    , selfTrace(nullptr)
+    , buildLog(nullptr)
+    , simulateCores(0u)
+    , pchBudget(0u)
+    , unityUnits(0u)
 {}
 
 namespace CommandLine
@@ -90,6 +98,15 @@ namespace CommandLine
 
         LOG_ALWAYS("-noincluders      (-ni)  : No includers file will be generated");
         LOG_ALWAYS("-keepTemplateArgs (-kta) : Keep the template arguments when provessing the symbol names.")
+        LOG_ALWAYS("                           The mangled Clang backend names are demangled to match the frontend ones, except in MSVC built extractors where they stay mangled");
+        LOG_ALWAYS("-heavyhitters     (-hh)  : Only keeps the top N symbols per category with bounded memory, the globals become approximate - example: '-hh 50000' (Clang only)");
+        LOG_ALWAYS("-sample           (-sa)  : Only processes the given percentage of traces picked by path, the totals are extrapolated - example: '-sa 10' (Clang only)");
+
+        LOG_ALWAYS("-ninjalog         (-nl)  : Joins the .ninja_log step times to the units and computes the build critical path - example: '-nl build/.ninja_log'");
+        LOG_ALWAYS("-simulate         (-sim) : Replays the units on N cores and ranks the wall time benefit of removing each header or speeding up each folder - example: '-sim 16'");
+        LOG_ALWAYS("-suggest-pch      (-pch) : Suggests the precompiled headers for all units and for each folder under the given budget of header parse time in ms - example: '-pch 2000'");
+        LOG_ALWAYS("-suggest-unity    (-uni) : Suggests unity build groups of up to N units sharing most of their includes - example: '-uni 8'");
+        LOG_ALWAYS("-selftrace        (-st)  : Writes a chrome trace of the extraction process itself to the given file - example: '-selftrace out.json'");
 
         LOG_ALWAYS("-verbosity        (-v)   : Sets the verbosity level - example: '-v 1'"); 
         LOG_ALWAYS("\t0 - Silent"); 
@@ -190,6 +207,25 @@ namespace CommandLine
                 {
                     params.templateArgs = ExportParams::TemplateArgs::Keep;
                 }
+                else if ((Utils::StringCompare(argValue,"-hh")==0 || Utils::StringCompare(argValue,"-heavyhitters")==0) && (i+1) < argc)
+                { 
+                    ++i;
+                    unsigned int value = 0;
+                    if (Utils::StringToUInt(value,argv[i]) && value > 0)
+                    { 
+                        params.globals = ExportParams::Globals::HeavyHitters;
+                        params.globalsCapacity = value;
+                    }
+                }
+                else if ((Utils::StringCompare(argValue,"-sa")==0 || Utils::StringCompare(argValue,"-sample")==0) && (i+1) < argc)
+                { 
+                    ++i;
+                    unsigned int value = 0;
+                    if (Utils::StringToUInt(value,argv[i]) && value > 0 && value <= 100)
+                    { 
+                        params.samplePercent = value;
+                    }
+                }
                 else if ((Utils::StringCompare(argValue,"-nt")==0 || Utils::StringCompare(argValue,"-notimeline")==0))
                 {
                     params.timeline = ExportParams::Timeline::Disabled;
@@ -221,6 +257,43 @@ namespace CommandLine
                         params.timelineDetail = ExportParams::Detail(value);
                     }
                 }
+                else if ((Utils::StringCompare(argValue,"-nl")==0 || Utils::StringCompare(argValue,"-ninjalog")==0) && (i+1) < argc)
+                { 
+                    ++i;
+                    params.buildLog = argv[i];
+                }
+                else if ((Utils::StringCompare(argValue,"-sim")==0 || Utils::StringCompare(argValue,"-simulate")==0) && (i+1) < argc)
+                { 
+                    ++i;
+                    unsigned int value = 0;
+                    if (Utils::StringToUInt(value,argv[i]) && value > 0)
+                    { 
+                        params.simulateCores = value;
+                    }
+                }
+                else if ((Utils::StringCompare(argValue,"-pch")==0 || Utils::StringCompare(argValue,"-suggest-pch")==0) && (i+1) < argc)
+                { 
+                    ++i;
+                    unsigned int value = 0;
+                    if (Utils::StringToUInt(value,argv[i]) && value > 0)
+                    { 
+                        params.pchBudget = value;
+                    }
+                }
+                else if ((Utils::StringCompare(argValue,"-uni")==0 || Utils::StringCompare(argValue,"-suggest-unity")==0) && (i+1) < argc)
+                { 
+                    ++i;
+                    unsigned int value = 0;
+                    if (Utils::StringToUInt(value,argv[i]) && value > 1)
+                    { 
+                        params.unityUnits = value;
+                    }
+                }
+                else if ((Utils::StringCompare(argValue,"-st")==0 || Utils::StringCompare(argValue,"-selftrace")==0) && (i+1) < argc)
+                { 
+                    ++i;
+                    params.selfTrace = argv[i];
+                }
                 else if ((Utils::StringCompare(argValue,"-v")==0 || Utils::StringCompare(argValue,"-verbosity")==0) && (i+1) < argc)
                 {
                     ++i;
@@ -238,6 +311,18 @@ namespace CommandLine
             }
         }
 
+        if (params.globals == ExportParams::Globals::HeavyHitters && params.source == ExportParams::Source::MSVC)
+        { 
+            LOG_ERROR("Heavy hitters mode is only supported for Clang, exporting exact globals.");
+            params.globals = ExportParams::Globals::Exact;
+        }
+
+        if (params.samplePercent < 100u && params.source == ExportParams::Source::MSVC)
+        { 
+            LOG_ERROR("Sampling is only supported for Clang, processing all the data.");
+            params.samplePercent = 100u;
+        }
+
         return 0;
     }
 }
\ No newline at end of file
@@ -47,6 +47,12 @@ struct ExportParams
         Keep,
     };
 
+    enum class Globals
+    {
+        Exact,
+        HeavyHitters,
+    };
+
     ExportParams();
 
     const char*  input; 
@@ -56,9 +62,17 @@ struct ExportParams
     Detail       detail;
     Includers    includers;
     TemplateArgs templateArgs;
+    Globals      globals;
+    unsigned int globalsCapacity;
+    unsigned int samplePercent;
     Timeline     timeline;
     Detail       timelineDetail;
     unsigned int timelinePacking;
+    const char*  selfTrace;
+    const char*  buildLog;
+    unsigned int simulateCores; //0 means no simulation
+    unsigned int pchBudget;     //0 means no PCH suggestions
+    unsigned int unityUnits;    //0 means no unity build suggestions
 };
 
 namespace CommandLine
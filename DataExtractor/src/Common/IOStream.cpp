@@ -1,14 +1,21 @@
 #include "IOStream.h"
 
 #include <cstdio>
+#include <cstring>
 #include <stdarg.h>
 
+#include "Profiler.h"
 #include "StringUtils.h"
+#include "Threading.h"
 
 #include "ScoreDefinitions.h"
 
-constexpr U32 SCORE_VERSION = 13;
+constexpr U32 SCORE_VERSION = 22;
 constexpr U32 TIMELINE_FILE_NUM_DIGITS = 4;
+constexpr U32 GLOBALS_FLAG_APPROXIMATE = 1u << 0; //heavy hitters mode, the globals come with error bounds
+constexpr U32 GLOBALS_FLAG_SAMPLED     = 1u << 1; //sampling mode, the globals are extrapolated and come with confidence intervals
+constexpr U32 SESSION_FLAG_SAMPLED     = 1u << 0; //sampling mode, the totals are extrapolated and come with confidence intervals
+constexpr U64 TEXT_BUFFER_PADDING = 16; //keeps block reads over the text terminator inside the allocation
 
 static_assert(TIMELINE_FILE_NUM_DIGITS > 0);
 
@@ -191,7 +198,7 @@ namespace IO
             long fsize = ftell(stream);
             fseek(stream, 0, SEEK_SET);  // same as rewind(f);
             
-            content = new char[(fsize+1ull)];
+            content = new char[(fsize+1ull+TEXT_BUFFER_PADDING)];
             if (fread(content, 1, fsize, stream) == 0)
             { 
                 LOG_ERROR("Something went wrong while reading the file %s.",filename);
@@ -201,13 +208,33 @@ namespace IO
             { 
                 content[fsize] = '\0';
             }
+
+            fclose(stream);
         }
         
-        fclose(stream);
-        
         return content;
     }
 
+    // -----------------------------------------------------------------------------------------------------------
+    bool ReadTextFileHeader(const char* filename, char* buffer, const U64 bufferSize)
+    {
+        //Reads only the first bufferSize-1 bytes of the file ( enough to sniff the file type without loading it all )
+        FILE* stream = Utils::OpenFile(filename, "rb");
+
+        if (stream == nullptr)
+        { 
+            LOG_ERROR("Unable to open the file %s", filename);
+            return false;
+        }
+
+        const size_t bytesRead = fread(buffer, 1, bufferSize - 1u, stream);
+        buffer[bytesRead] = '\0';
+
+        fclose(stream);
+
+        return bytesRead > 0u;
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////
     class TextOutputStream::Impl
     {
@@ -297,6 +324,21 @@ namespace IO
         m_impl->Write(&c,sizeof(char),1);
     }
 
+    // -----------------------------------------------------------------------------------------------------------
+    void TextOutputStream::AppendFormat(const char* format, ...)
+    { 
+        char buffer[1024];
+        va_list args;
+        va_start(args, format);
+        const int length = vsnprintf(buffer, sizeof(buffer), format, args);
+        va_end(args);
+
+        if (length > 0)
+        { 
+            Append(buffer, length < static_cast<int>(sizeof(buffer)) ? length : sizeof(buffer) - 1);
+        }
+    }
+
     // -----------------------------------------------------------------------------------------------------------
     void DestroyBuffer(FileTextBuffer& buffer)
     {
@@ -310,23 +352,93 @@ namespace IO
 
     namespace Utils
     { 
+        //////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Growable memory output, sections get serialized in memory so they can be built in parallel
+        class BinaryBuffer
+        { 
+        public: 
+            BinaryBuffer() : m_data(nullptr), m_size(0u), m_capacity(0u) {}
+            ~BinaryBuffer() { delete [] m_data; }
+
+            BinaryBuffer(BinaryBuffer&& input) : m_data(input.m_data), m_size(input.m_size), m_capacity(input.m_capacity) 
+            { 
+                input.m_data = nullptr;
+                input.m_size = 0u;
+                input.m_capacity = 0u;
+            }
+
+            BinaryBuffer& operator = (BinaryBuffer&& input)
+            { 
+                if (this != &input)
+                { 
+                    delete [] m_data;
+                    m_data = input.m_data;
+                    m_size = input.m_size;
+                    m_capacity = input.m_capacity;
+                    input.m_data = nullptr;
+                    input.m_size = 0u;
+                    input.m_capacity = 0u;
+                }
+                return *this;
+            }
+
+            BinaryBuffer(const BinaryBuffer& input) = delete;
+            BinaryBuffer& operator = (const BinaryBuffer& input) = delete;
+
+            void Write(const void* data, const U64 size)
+            { 
+                if (m_size + size > m_capacity) 
+                { 
+                    Grow(m_size + size);
+                }
+
+                memcpy(m_data + m_size, data, size);
+                m_size += size;
+            }
+
+            void Clear() { m_size = 0u; }
+            void Flush(FILE* stream) const { fwrite(m_data, sizeof(char), m_size, stream); }
+
+        private: 
+            void Grow(const U64 minCapacity)
+            { 
+                U64 capacity = m_capacity? m_capacity * 2u : 4096u;
+                capacity = capacity < minCapacity? minCapacity : capacity;
+
+                char* data = new char[capacity];
+                if (m_data) 
+                { 
+                    memcpy(data, m_data, m_size);
+                    delete [] m_data;
+                }
+
+                m_data = data;
+                m_capacity = capacity;
+            }
+
+        private: 
+            char* m_data; 
+            U64   m_size;
+            U64   m_capacity;
+        };
+
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeString(FILE* stream, const fastl::string& str)
+        void BinarizeString(BinaryBuffer& stream, const fastl::string& str)
         {
             //Perform size encoding in 7bitSize format
             U64 strSize = str.length();
             do
             {
                 const U8 val = strSize < 0x80 ? strSize & 0x7F : (strSize & 0x7F) | 0x80;
-                fwrite(&val, sizeof(U8), 1, stream);
+                stream.Write(&val, sizeof(U8));
                 strSize >>= 7;
             } while (strSize);
 
-            fwrite(str.c_str(), str.length(), 1, stream);
+            stream.Write(str.c_str(), str.length());
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeStringHash(FILE* stream, const TCompileStrings& strings, U64 strHash)
+        void BinarizeStringHash(BinaryBuffer& stream, const TCompileStrings& strings, U64 strHash)
         {
             TCompileStrings::const_iterator found = strings.find(strHash);
             if (found != strings.end())
@@ -340,7 +452,7 @@ namespace IO
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeStringPath(FILE* stream, const TCompileStrings& strings, U64 strHash)
+        void BinarizeStringPath(BinaryBuffer& stream, const TCompileStrings& strings, U64 strHash)
         {
             TCompileStrings::const_iterator found = strings.find(strHash);
             if (found != strings.end())
@@ -356,25 +468,25 @@ namespace IO
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeU8(FILE* stream, const U8 input)
+        void BinarizeU8(BinaryBuffer& stream, const U8 input)
         { 
-            fwrite(&input,sizeof(U8),1,stream);
+            stream.Write(&input,sizeof(U8));
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeU32(FILE* stream, const U32 input)
+        void BinarizeU32(BinaryBuffer& stream, const U32 input)
         { 
-            fwrite(&input,sizeof(U32),1,stream);
+            stream.Write(&input,sizeof(U32));
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeU64(FILE* stream, const U64 input)
+        void BinarizeU64(BinaryBuffer& stream, const U64 input)
         { 
-            fwrite(&input,sizeof(U64),1,stream);
+            stream.Write(&input,sizeof(U64));
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeIncluderUnitMap(FILE* stream, const TCompileIncluderUnitMap& includerMap)
+        void BinarizeIncluderUnitMap(BinaryBuffer& stream, const TCompileIncluderUnitMap& includerMap)
         {
             BinarizeU32(stream, static_cast<U32>(includerMap.size()));
             for (const TCompileIncluderUnitMap::value_type& pair : includerMap)
@@ -385,7 +497,7 @@ namespace IO
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeIncluderInclMap(FILE* stream, const TCompileIncluderInclMap& includerMap)
+        void BinarizeIncluderInclMap(BinaryBuffer& stream, const TCompileIncluderInclMap& includerMap)
         {
             BinarizeU32(stream, static_cast<U32>(includerMap.size()));
             for (const TCompileIncluderInclMap::value_type& pair : includerMap)
@@ -399,24 +511,29 @@ namespace IO
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeIncluder( FILE* stream, const CompileIncluder& includer )
+        void BinarizeIncluder( BinaryBuffer& stream, const CompileIncluder& includer )
         {
             BinarizeIncluderInclMap( stream, includer.includes );
             BinarizeIncluderUnitMap( stream, includer.units );
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeIncluders(FILE* stream, const TCompileIncluders& includers )
+        void BinarizeIncluders(BinaryBuffer& stream, const TCompileIncluders& includers, const size_t begin, const size_t end)
         {
-			BinarizeU32( stream, static_cast< U32 >( includers.size() ) );
-			for( const CompileIncluder& includer : includers )
+            //the first chunk of the section carries the element count
+            if (begin == 0u) 
+            { 
+                BinarizeU32( stream, static_cast< U32 >( includers.size() ) );
+            }
+
+			for( size_t i = begin; i < end; ++i )
 			{
-                BinarizeIncluder( stream, includer );
+                BinarizeIncluder( stream, includers[i] );
 			}
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeUnit(FILE* stream, const TCompileStrings& strings, const CompileUnit& unit)
+        void BinarizeUnit(BinaryBuffer& stream, const TCompileStrings& strings, const CompileUnit& unit)
         { 
             //Name
             BinarizeStringPath(stream, strings, unit.nameHash);
@@ -429,21 +546,30 @@ namespace IO
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeUnits(FILE* stream, const TCompileStrings& strings, const TCompileUnits& units)
+        void BinarizeUnits(BinaryBuffer& stream, const TCompileStrings& strings, const TCompileUnits& units, const size_t begin, const size_t end)
         {
-            BinarizeU32(stream,static_cast<U32>(units.size()));
-            for (const CompileUnit& unit : units)
+            if (begin == 0u) 
             { 
-                BinarizeUnit(stream,strings,unit);
+                BinarizeU32(stream,static_cast<U32>(units.size()));
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            { 
+                BinarizeUnit(stream,strings,units[i]);
             }
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeGlobalsStr(FILE* stream, const TCompileStrings& strings, const TCompileDatas& globals)
+        void BinarizeGlobalsStr(BinaryBuffer& stream, const TCompileStrings& strings, const TCompileDatas& globals, const size_t begin, const size_t end)
         {
-            BinarizeU32(stream,static_cast<U32>(globals.size()));
-            for (const CompileData& data : globals)
+            if (begin == 0u) 
+            { 
+                BinarizeU32(stream, static_cast<U32>(globals.size()));
+            }
+
+            for (size_t i = begin; i < end; ++i)
             { 
+                const CompileData& data = globals[i];
                 BinarizeStringHash(stream,strings,data.nameHash);
 				BinarizeU64(stream, data.accumulated);
 				BinarizeU64(stream, data.selfAccumulated);
@@ -455,15 +581,23 @@ namespace IO
                 BinarizeU32(stream, data.selfMaxId);
                 BinarizeU64(stream, data.unitAccumulated);
                 BinarizeU32(stream, data.unitCount);
+                BinarizeU32(stream, data.p50);
+                BinarizeU32(stream, data.p90);
+                BinarizeU32(stream, data.p99);
             }
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeGlobalsPath(FILE* stream, const TCompileStrings& strings, const TCompileDatas& globals)
+        void BinarizeGlobalsPath(BinaryBuffer& stream, const TCompileStrings& strings, const TCompileDatas& globals, const size_t begin, const size_t end)
         {
-            BinarizeU32(stream, static_cast<U32>(globals.size()));
-            for (const CompileData& data : globals)
-            {
+            if (begin == 0u) 
+            { 
+                BinarizeU32(stream, static_cast<U32>(globals.size()));
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            { 
+                const CompileData& data = globals[i];
                 BinarizeStringPath(stream, strings, data.nameHash);
                 BinarizeU64(stream, data.accumulated);
                 BinarizeU64(stream, data.selfAccumulated);
@@ -475,11 +609,14 @@ namespace IO
                 BinarizeU32(stream, data.selfMaxId);
                 BinarizeU64(stream, data.unitAccumulated);
                 BinarizeU32(stream, data.unitCount);
+                BinarizeU32(stream, data.p50);
+                BinarizeU32(stream, data.p90);
+                BinarizeU32(stream, data.p99);
             }
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeTags( FILE* stream, const TCompileStrings& strings, const TTags& tags )
+        void BinarizeTags( BinaryBuffer& stream, const TCompileStrings& strings, const TTags& tags )
         {
 			BinarizeU32( stream, static_cast< U32 >( tags.size() ) );
             for( U64 nameHash : tags )
@@ -489,7 +626,7 @@ namespace IO
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeFolders(FILE* stream, const TCompileFolders& folders)
+        void BinarizeFolders(BinaryBuffer& stream, const TCompileFolders& folders)
         {
             BinarizeU32(stream, static_cast<U32>(folders.size()));
             for (const CompileFolder& folder : folders)
@@ -516,7 +653,7 @@ namespace IO
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeTimelineEvents(FILE* stream, const TCompileEvents& events)
+        void BinarizeTimelineEvents(BinaryBuffer& stream, const TCompileEvents& events)
         { 
             BinarizeU32(stream,static_cast<unsigned int>(events.size()));
             for (const CompileEvent& evt : events)
@@ -529,7 +666,7 @@ namespace IO
         }
 
         // -----------------------------------------------------------------------------------------------------------
-        void BinarizeSession(FILE* stream, const CompileSession& session)
+        void BinarizeSession(BinaryBuffer& stream, const CompileSession& session)
         {
             BinarizeU64(stream, session.fullDuration);
 
@@ -537,6 +674,275 @@ namespace IO
             {
                 BinarizeU64(stream, session.totals[i]);
             }
+
+            BinarizeU32(stream, session.IsSampled()? SESSION_FLAG_SAMPLED : 0u);
+
+            if (session.IsSampled())
+            { 
+                BinarizeU32(stream, session.sampledFiles);
+                BinarizeU32(stream, session.totalFiles);
+                for (U64 i = 0; i < ToUnderlying(CompileCategory::DisplayCount); ++i)
+                {
+                    BinarizeU64(stream, session.totalsMargin[i]);
+                }
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void BinarizeConcurrency(BinaryBuffer& stream, const CompileConcurrency& concurrency)
+        {
+            BinarizeU32(stream, concurrency.peak);
+
+            BinarizeU32(stream, static_cast<U32>(concurrency.levelDurations.size()));
+            for (U64 duration : concurrency.levelDurations)
+            {
+                BinarizeU64(stream, duration);
+            }
+
+            BinarizeU64(stream, concurrency.sliceDuration);
+            BinarizeU32(stream, static_cast<U32>(concurrency.sliceActivity.size()));
+            for (U64 activity : concurrency.sliceActivity)
+            {
+                BinarizeU64(stream, activity);
+            }
+
+            BinarizeU64(stream, concurrency.tailStart);
+            BinarizeU32(stream, static_cast<U32>(concurrency.tailUnitIds.size()));
+            for (U32 unitId : concurrency.tailUnitIds)
+            {
+                BinarizeU32(stream, unitId);
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void BinarizeBuildLog(BinaryBuffer& stream, const CompileBuildLog& buildLog)
+        {
+            BinarizeU32(stream, static_cast<U32>(buildLog.steps.size()));
+            for (const CompileBuildStep& step : buildLog.steps)
+            {
+                BinarizeString(stream, step.output);
+                BinarizeU64(stream, step.start);
+                BinarizeU64(stream, step.end);
+                BinarizeU64(stream, step.slack);
+                BinarizeU32(stream, step.unitId);
+                BinarizeU8(stream, step.critical ? 1u : 0u);
+            }
+
+            BinarizeU32(stream, static_cast<U32>(buildLog.criticalPath.size()));
+            for (U32 stepId : buildLog.criticalPath)
+            {
+                BinarizeU32(stream, stepId);
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void BinarizeIncludeCosts(BinaryBuffer& stream, const TCompileIncludeCosts& includeCosts, const size_t begin, const size_t end)
+        {
+            if (begin == 0u) 
+            { 
+                BinarizeU32(stream, static_cast<U32>(includeCosts.size()));
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            { 
+                BinarizeU64(stream, includeCosts[i].exclusive);
+                BinarizeU64(stream, includeCosts[i].rebuildCost);
+                BinarizeU32(stream, includeCosts[i].rebuildUnits);
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void BinarizeScopes(BinaryBuffer& stream, const TCompileScopes& scopes, const size_t begin, const size_t end)
+        {
+            if (begin == 0u) 
+            { 
+                BinarizeU32(stream, static_cast<U32>(scopes.size()));
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            { 
+                const CompileScope& scope = scopes[i];
+                BinarizeString(stream, scope.name);
+                BinarizeU32(stream, static_cast<U32>(scope.children.size()));
+                for (const auto& child : scope.children)
+                {
+                    BinarizeU32(stream, child.second);
+                }
+
+                for (size_t category = ToUnderlying(CompileCategory::Include) + 1u; category < ToUnderlying(CompileCategory::GatherFull); ++category)
+                {
+                    BinarizeU64(stream, scope.accumulated[category]);
+                    BinarizeU64(stream, scope.selfAccumulated[category]);
+                    BinarizeU32(stream, scope.count[category]);
+                }
+            }
+        }
+
+        //////////////////////////////////////////////////////////////////////////////////////////////////////////
+        // Section chunks serialized independently, the buffers are written to the files in job order afterwards
+        struct SerializeJob
+        { 
+            using TFunc = void(*)(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64 param);
+
+            SerializeJob(TFunc _func, const size_t _begin, const size_t _end, const U64 _param)
+                : func(_func), begin(_begin), end(_end), param(_param)
+            {}
+
+            TFunc        func;
+            size_t       begin; 
+            size_t       end;
+            U64          param;
+            BinaryBuffer buffer;
+        };
+
+        using TSerializeJobs = fastl::vector<SerializeJob>;
+
+        enum { SERIALIZE_CHUNK_SIZE = 4096 };
+
+        // -----------------------------------------------------------------------------------------------------------
+        void AddSerializeJobs(TSerializeJobs& jobs, SerializeJob::TFunc func, const size_t count, const U64 param = 0u)
+        { 
+            //always add the first chunk, it carries the element count
+            size_t begin = 0u;
+            do
+            { 
+                const size_t end = begin + SERIALIZE_CHUNK_SIZE < count? begin + SERIALIZE_CHUNK_SIZE : count;
+                jobs.emplace_back(func, begin, end, param);
+                begin = end;
+            }
+            while (begin < count);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeGlobalsHeader(BinaryBuffer& stream, const ScoreData& data, const size_t, const size_t, const U64)
+        { 
+            BinarizeU32(stream, SCORE_VERSION);
+            const U32 flags = (data.globalsCapacity? GLOBALS_FLAG_APPROXIMATE : 0u) | (data.session.IsSampled()? GLOBALS_FLAG_SAMPLED : 0u);
+            BinarizeU32(stream, flags);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeGlobalsStr(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64 category)
+        { 
+            BinarizeGlobalsStr(stream, data.strings, data.globals[category], begin, end);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeGlobalsPath(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64 category)
+        { 
+            BinarizeGlobalsPath(stream, data.strings, data.globals[category], begin, end);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeTags(BinaryBuffer& stream, const ScoreData& data, const size_t, const size_t, const U64)
+        { 
+            BinarizeTags(stream, data.strings, data.otherTags);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeGlobalsErrors(BinaryBuffer& stream, const ScoreData& data, const size_t, const size_t, const U64 category)
+        { 
+            //maximum overestimation of each entry accumulated time, only present for the approximated categories
+            const fastl::vector<U64>& errors = data.globalsSketch[category].errors;
+            BinarizeU32(stream, static_cast<U32>(errors.size()));
+            for (U64 error : errors)
+            { 
+                BinarizeU64(stream, error);
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeGlobalsMargins(BinaryBuffer& stream, const ScoreData& data, const size_t, const size_t, const U64 category)
+        { 
+            //confidence interval of each extrapolated entry accumulated time
+            const TSampleMargins& margins = data.globalsMargin[category];
+            BinarizeU32(stream, static_cast<U32>(margins.size()));
+            for (U64 margin : margins)
+            { 
+                BinarizeU64(stream, margin);
+            }
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeScopes(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64)
+        { 
+            BinarizeScopes(stream, data.scopes, begin, end);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeOtherDatas(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64)
+        { 
+            BinarizeGlobalsStr(stream, data.strings, data.otherDatas, begin, end);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializePasses(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64)
+        { 
+            BinarizeGlobalsStr(stream, data.strings, data.passes, begin, end);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeMainHeader(BinaryBuffer& stream, const ScoreData& data, const size_t, const size_t, const U64 timelinesPerFile)
+        { 
+            BinarizeU32(stream, SCORE_VERSION);
+            BinarizeU32(stream, static_cast<U32>(timelinesPerFile));
+            BinarizeSession(stream, data.session);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeUnits(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64)
+        { 
+            BinarizeUnits(stream, data.strings, data.units, begin, end);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeFolders(BinaryBuffer& stream, const ScoreData& data, const size_t, const size_t, const U64)
+        { 
+            BinarizeFolders(stream, data.folders);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeIncluders(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64)
+        { 
+            BinarizeIncluders(stream, data.includers, begin, end);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeConcurrency(BinaryBuffer& stream, const ScoreData& data, const size_t, const size_t, const U64)
+        { 
+            BinarizeConcurrency(stream, data.concurrency);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeBuildLog(BinaryBuffer& stream, const ScoreData& data, const size_t, const size_t, const U64)
+        { 
+            BinarizeBuildLog(stream, data.buildLog);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        void SerializeIncludeCosts(BinaryBuffer& stream, const ScoreData& data, const size_t begin, const size_t end, const U64)
+        { 
+            BinarizeIncludeCosts(stream, data.includeCosts, begin, end);
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        bool WriteJobs(const char* filename, const TSerializeJobs& jobs, const size_t begin, const size_t end)
+        { 
+            FILE* stream = OpenFile(filename, "wb");
+
+            if (stream == nullptr)
+            {
+                LOG_ERROR("Unable to create output file %s", filename);
+                return false;
+            }
+
+            for (size_t i = begin; i < end; ++i)
+            { 
+                jobs[i].buffer.Flush(stream);
+            }
+
+            fclose(stream);
+            return true;
         }
     }
 
@@ -557,8 +963,7 @@ namespace IO
 
         U32 GetTimelinesPerFile() const { return timelinesPerFile; }
 
-        void BinarizeGlobals( const ScoreData& data );
-        void BinarizeMain( const ScoreData& data );
+        void BinarizeData( const ScoreData& data );
 
     private: 
         bool AppendTimelineExtension(fastl::string& filename);
@@ -566,6 +971,9 @@ namespace IO
     public: 
         const char* path;
 
+    public: 
+        Utils::BinaryBuffer timelineBuffer;
+
     private:
         FILE*       timelineStream; 
         U64         timelineCount;
@@ -614,11 +1022,12 @@ namespace IO
                 if (timelineStream == nullptr) 
                 { 
                     LOG_ERROR("Unable to create output file %s",filename.c_str());
-                    timelineStream = nullptr;
                 }
-
-                //Add the file header
-                Utils::BinarizeU32(timelineStream,SCORE_VERSION);
+                else
+                { 
+                    //Add the file header
+                    fwrite(&SCORE_VERSION,sizeof(U32),1,timelineStream);
+                }
             }
         }
 
@@ -637,89 +1046,94 @@ namespace IO
     }
 
     // -----------------------------------------------------------------------------------------------------------
-    void ScoreBinarizer::Impl::BinarizeGlobals(const ScoreData& data)
+    void ScoreBinarizer::Impl::BinarizeData(const ScoreData& data)
     {
-        bool hasContent = false;
+        bool hasGlobalsContent = false;
         constexpr U64 firstIndex = ToUnderlying(CompileCategory::Include) + 1;
         constexpr U64 lastIndex = ToUnderlying(CompileCategory::GatherFull);
         for (U64 i = firstIndex; i < lastIndex; ++i)
         {
-            hasContent = hasContent || data.globals[i].empty();
+            hasGlobalsContent = hasGlobalsContent || data.globals[i].empty();
         }
 
-        if (!hasContent)
-        {
-            return;
-        }
-
-        fastl::string filename = path;
-        filename.append(".gbl");
-
-        LOG_INFO("Writing to file %s", filename.c_str());
-
-        FILE* stream = Utils::OpenFile(filename.c_str(), "wb");
-       
-        if (stream == nullptr)
-        {
-            LOG_ERROR("Unable to create output file %s", filename.c_str());
-            return;
-        }
+        //Split all sections in chunks and serialize them in parallel
+        Utils::TSerializeJobs jobs;
 
-        //Header
-        Utils::BinarizeU32(stream, SCORE_VERSION);
-
-        for (U64 i = firstIndex; i < lastIndex; ++i)
-        {
-            if (i == ToUnderlying(CompileCategory::OptimizeModule))
-            {
-                Utils::BinarizeGlobalsPath(stream, data.strings, data.globals[i]);
-            }
-            else
+        if (hasGlobalsContent)
+        { 
+            Utils::AddSerializeJobs(jobs, &Utils::SerializeGlobalsHeader, 0u);
+            for (U64 i = firstIndex; i < lastIndex; ++i)
             {
-                Utils::BinarizeGlobalsStr(stream, data.strings, data.globals[i]);
+                Utils::SerializeJob::TFunc func = i == ToUnderlying(CompileCategory::OptimizeModule)? &Utils::SerializeGlobalsPath : &Utils::SerializeGlobalsStr;
+                Utils::AddSerializeJobs(jobs, func, data.globals[i].size(), i);
             }
-        }
+            Utils::AddSerializeJobs(jobs, &Utils::SerializeTags, 0u);
 
-        Utils::BinarizeTags(stream, data.strings, data.otherTags);
-
-        fclose(stream);
+            if (data.globalsCapacity)
+            { 
+                for (U64 i = firstIndex; i < lastIndex; ++i)
+                {
+                    Utils::AddSerializeJobs(jobs, &Utils::SerializeGlobalsErrors, 0u, i);
+                }
+            }
 
-        LOG_INFO("Global datas exported!");
-    }
+            if (data.session.IsSampled())
+            { 
+                for (U64 i = firstIndex; i < lastIndex; ++i)
+                {
+                    Utils::AddSerializeJobs(jobs, &Utils::SerializeGlobalsMargins, 0u, i);
+                }
+            }
 
-    // -----------------------------------------------------------------------------------------------------------
-    void ScoreBinarizer::Impl::BinarizeMain(const ScoreData& data)
-    {
-        const char* filename = path;
+            Utils::AddSerializeJobs(jobs, &Utils::SerializeScopes, data.scopes.size());
+            Utils::AddSerializeJobs(jobs, &Utils::SerializePasses, data.passes.size());
+            Utils::AddSerializeJobs(jobs, &Utils::SerializeOtherDatas, data.otherDatas.size());
+        }
 
-        LOG_PROGRESS("Writing to file %s", filename);
+        const size_t numGlobalsJobs = jobs.size();
 
-        FILE* stream = Utils::OpenFile(filename, "wb");
+        Utils::AddSerializeJobs(jobs, &Utils::SerializeMainHeader, 0u, GetTimelinesPerFile());
+        Utils::AddSerializeJobs(jobs, &Utils::SerializeUnits, data.units.size());
+        Utils::AddSerializeJobs(jobs, &Utils::SerializeGlobalsPath, data.globals[ToUnderlying(CompileCategory::Include)].size(), ToUnderlying(CompileCategory::Include));
+        Utils::AddSerializeJobs(jobs, &Utils::SerializeFolders, 0u);
+        Utils::AddSerializeJobs(jobs, &Utils::SerializeIncluders, data.includers.size());
 
-        if (stream == nullptr)
-        {
-            LOG_ERROR("Unable to create output file %s", filename);
-            return;
+        if (data.session.IsSampled())
+        { 
+            Utils::AddSerializeJobs(jobs, &Utils::SerializeGlobalsMargins, 0u, ToUnderlying(CompileCategory::Include));
         }
 
-        //Header
-        Utils::BinarizeU32(stream, SCORE_VERSION);
-        Utils::BinarizeU32(stream, GetTimelinesPerFile());
+        Utils::AddSerializeJobs(jobs, &Utils::SerializeConcurrency, 0u);
+        Utils::AddSerializeJobs(jobs, &Utils::SerializeBuildLog, 0u);
+        Utils::AddSerializeJobs(jobs, &Utils::SerializeIncludeCosts, data.includeCosts.size());
 
-        //Session
-        Utils::BinarizeSession(stream, data.session);
+        auto serializeJob = [&](const size_t index)
+        { 
+            Utils::SerializeJob& job = jobs[index];
+            job.func(job.buffer, data, job.begin, job.end, job.param);
+        };
+        Threading::ParallelFor("Serialize", jobs.size(), serializeJob);
 
-        //Content
-        Utils::BinarizeUnits(stream, data.strings, data.units);
-        Utils::BinarizeGlobalsPath(stream, data.strings, data.globals[ToUnderlying(CompileCategory::Include)]);
-        
-        Utils::BinarizeFolders(stream, data.folders);
+        //do the globals first as the Scoredata file close might trigger refreshers on listeners ( it needs to be the last file to be created ) 
+        if (hasGlobalsContent)
+        { 
+            fastl::string filename = path;
+            filename.append(".gbl");
 
-        Utils::BinarizeIncluders(stream, data.includers);
+            LOG_INFO("Writing to file %s", filename.c_str());
 
-        fclose(stream);
+            if (Utils::WriteJobs(filename.c_str(), jobs, 0u, numGlobalsJobs))
+            { 
+                LOG_INFO("Global datas exported!");
+            }
+        }
+
+        LOG_PROGRESS("Writing to file %s", path);
 
-        LOG_INFO("Units exported!");
+        if (Utils::WriteJobs(path, jobs, numGlobalsJobs, jobs.size()))
+        { 
+            LOG_INFO("Units exported!");
+        }
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -738,9 +1152,9 @@ namespace IO
     // -----------------------------------------------------------------------------------------------------------
     void ScoreBinarizer::Binarize(const ScoreData& data)
     { 
-        //do this one first as the Scoredata file close might trigger refreshers on listeners ( it needs to be the last file to be created ) 
-        m_impl->BinarizeGlobals( data );
-        m_impl->BinarizeMain( data );
+        PROFILE_ZONE("Binarize");
+
+        m_impl->BinarizeData( data );
 
         LOG_PROGRESS("Done!");
     }
@@ -748,14 +1162,21 @@ namespace IO
     // -----------------------------------------------------------------------------------------------------------
     void ScoreBinarizer::Binarize(const ScoreTimeline& timeline)
     { 
+        PROFILE_ZONE("Binarize Timeline");
+
         if (FILE* stream = m_impl->NextTimelineStream())
         { 
-            Utils::BinarizeU32(stream,static_cast<unsigned int>(timeline.tracks.size()));
+            Utils::BinaryBuffer& buffer = m_impl->timelineBuffer;
+            buffer.Clear();
+
+            Utils::BinarizeU32(buffer,static_cast<unsigned int>(timeline.tracks.size()));
             for (const TCompileEvents& events : timeline.tracks)
             { 
-                Utils::BinarizeTimelineEvents(stream,events);
+                Utils::BinarizeTimelineEvents(buffer,events);
             }
 
+            buffer.Flush(stream);
+
             LOG_INFO("Timeline exported (Hash: 0x%llx)", timeline.nameHash);
         }
     }
@@ -59,6 +59,7 @@ namespace IO
     using FileTextBuffer = char*; 
     
     FileTextBuffer ReadTextFile(const char* filename);
+    bool ReadTextFileHeader(const char* filename, char* buffer, const U64 bufferSize);
     void DestroyBuffer(FileTextBuffer& buffer);
     
     //////////////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +78,7 @@ namespace IO
         void Append(const char* txt, const U64 length);
         void Append(const char* txt);
         void Append(const char c);
+        void AppendFormat(const char* format, ...);
 
     private:
         class Impl;
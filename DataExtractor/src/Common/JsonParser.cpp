@@ -2,8 +2,73 @@
 
 #include "../fastl/string.h"
 
+#include "SIMD.h"
+
 namespace Json
 {
+    namespace Utils
+    { 
+        // -----------------------------------------------------------------------------------------------------------
+        inline bool IsWhitespace(const char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+        // -----------------------------------------------------------------------------------------------------------
+        const char* SkipSeparators(const char* cursor)
+        { 
+            while (IsWhitespace(*cursor)) ++cursor;
+            if (*cursor == ',' || *cursor == ':') ++cursor;
+            while (IsWhitespace(*cursor)) ++cursor;
+            return cursor;
+        }
+
+#ifdef SIMD_USE_SSE2
+        // -----------------------------------------------------------------------------------------------------------
+        // Walks over a nested value only looking at the structural characters ( brackets, quotes and escapes )
+        // Returns the position right after the character that closes the value or the position of the buffer terminator
+        const char* SkipStructure(const char* cursor, int level, bool inString)
+        { 
+            //Aligned loads never cross a page boundary, so it is safe to read the block that holds the terminator
+            const size_t misalignment = reinterpret_cast<size_t>(cursor) & (SIMD::BLOCK_SIZE - 1u);
+            const char* block = cursor - misalignment;
+            U32 ignoreMask = (1u << misalignment) - 1u;
+
+            for(;;block += SIMD::BLOCK_SIZE)
+            { 
+                const __m128i data = SIMD::LoadAligned(block);
+                U32 mask = SIMD::FindMask(data, '\"') | SIMD::FindMask(data, '\\') | SIMD::FindMask(data, '\0')
+                         | SIMD::FindMask(data, '{')  | SIMD::FindMask(data, '}')  
+                         | SIMD::FindMask(data, '[')  | SIMD::FindMask(data, ']');
+                mask &= ~ignoreMask;
+                ignoreMask = 0u;
+
+                for(;mask;mask &= mask - 1u)
+                { 
+                    const U32 index = SIMD::FirstSetBit(mask);
+                    const char c = block[index];
+
+                    if (c == '\0') return block + index;
+
+                    if (inString)
+                    { 
+                        if (c == '\"') inString = false;
+                        else if (c == '\\')
+                        { 
+                            //skip the escaped character
+                            if (block[index+1] == '\0') return block + index + 1;
+                            if (index + 1u < SIMD::BLOCK_SIZE) mask &= ~(1u << (index + 1u));
+                            else ignoreMask = 1u;
+                        }
+                    }
+                    else if (c == '\"') inString = true;
+                    else if (c == '{' || c == '[') ++level;
+                    else if (c == '}' || c == ']') --level;
+
+                    if (level <= 0 && !inString) return block + index + 1;
+                }
+            }
+        }
+#endif
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
     // -----------------------------------------------------------------------------------------------------------
@@ -15,9 +80,7 @@ namespace Json
     bool Reader::NextToken(Token& token)
     { 
         //skip all whitespace and separators
-        while(*cursor == ' ' || *cursor == '\n' || *cursor == '\r' || *cursor == '\t') ++cursor;
-        if (*cursor == ',' || *cursor == ':') ++cursor;
-        while (*cursor == ' ' || *cursor == '\n' || *cursor == '\r' || *cursor == '\t') ++cursor;
+        cursor = Utils::SkipSeparators(cursor);
 
         switch(*cursor)
         { 
@@ -37,7 +100,8 @@ namespace Json
         case '\"': 
         { 
             token.str = ++cursor;
-            while(*cursor != '\"' || *(cursor-1) == '\\') ++cursor; //find the end of the string
+            while((*cursor != '\"' || *(cursor-1) == '\\') && *cursor != '\0') ++cursor; //find the end of the string
+            if (*cursor == '\0') { token.type = Token::Type::EndOfFile; return false; } //truncated buffer
             token.length = cursor-token.str;
             token.type = Token::Type::String;
             ++cursor; //advance the closing '"'
@@ -63,14 +127,31 @@ namespace Json
     // -----------------------------------------------------------------------------------------------------------
     void Reader::SkipObject()
     { 
+#ifdef SIMD_USE_SSE2
+        cursor = Utils::SkipSeparators(cursor);
+
+        switch(*cursor)
+        { 
+        case '{': 
+        case '[':  cursor = Utils::SkipStructure(cursor, 0, false); break;
+        case '\"': cursor = Utils::SkipStructure(cursor + 1, 0, true); break;
+        default: 
+        { 
+            //scalar values and unexpected closures go through the regular tokenizer
+            Token token;
+            NextToken(token);
+        }
+        }
+#else
         Token token;
         int level = 0;
         do
         { 
-            NextToken(token); 
+            if (!NextToken(token)) break; //truncated or malformed buffer
             if (token.type == Token::Type::ObjectOpen  || token.type == Token::Type::ArrayOpen)  ++level;
             if (token.type == Token::Type::ObjectClose || token.type == Token::Type::ArrayClose) --level;
         }
         while(level > 0);
+#endif
     }
 }
\ No newline at end of file
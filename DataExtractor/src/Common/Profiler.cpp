@@ -0,0 +1,182 @@
+#include "Profiler.h"
+
+#ifdef USE_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <vector>
+
+#include "IOStream.h"
+
+namespace Profiler
+{
+	namespace Utils
+	{
+		enum
+		{
+			RING_CAPACITY = 16*1024,
+			RING_MASK     = RING_CAPACITY - 1
+		};
+		static_assert(( RING_CAPACITY & RING_MASK ) == 0u, "RING_CAPACITY must be a power of 2");
+
+		struct Record
+		{
+			const char* name;
+			U64         start;
+			U64         end;
+		};
+
+		// Each thread only writes to its own ring, once full the oldest zones get overwritten
+		struct ThreadBuffer
+		{
+			explicit ThreadBuffer(U32 _threadId) : count(0u), threadId(_threadId) {}
+
+			Record records[RING_CAPACITY];
+			U64    count;
+			U32    threadId;
+		};
+
+		// -----------------------------------------------------------------------------------------------------------
+		class Registry
+		{
+		public:
+			~Registry()
+			{
+				for (ThreadBuffer* buffer : buffers)
+				{
+					delete buffer;
+				}
+			}
+
+			ThreadBuffer* CreateBuffer()
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				ThreadBuffer* buffer = new ThreadBuffer(static_cast<U32>(buffers.size()));
+				buffers.push_back(buffer);
+				return buffer;
+			}
+
+			std::mutex                 mutex;
+			std::vector<ThreadBuffer*> buffers;
+		};
+
+		Registry                              g_registry;
+		std::atomic<bool>                     g_enabled{false};
+		std::chrono::steady_clock::time_point g_captureStart;
+
+		// -----------------------------------------------------------------------------------------------------------
+		inline U64 Now()
+		{
+			return static_cast<U64>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_captureStart).count());
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		ThreadBuffer& GetThreadBuffer()
+		{
+			thread_local ThreadBuffer* buffer = g_registry.CreateBuffer();
+			return *buffer;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void WriteTraceEvent(IO::TextOutputStream& stream, const Record& record, const U32 threadId, bool& isFirst)
+		{
+			char buffer[512];
+			const int length = snprintf(buffer, sizeof(buffer), "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+				isFirst? "" : ",", record.name, record.start/1000.0, (record.end-record.start)/1000.0, threadId);
+			stream.Append(buffer, length);
+			isFirst = false;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void WriteThreadName(IO::TextOutputStream& stream, const U32 threadId, bool& isFirst)
+		{
+			char buffer[256];
+			const int length = threadId == 0u?
+				snprintf(buffer, sizeof(buffer), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Main\"}}", isFirst? "" : ",", threadId) :
+				snprintf(buffer, sizeof(buffer), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"Worker %u\"}}", isFirst? "" : ",", threadId, threadId);
+			stream.Append(buffer, length);
+			isFirst = false;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool IsAvailable()
+	{
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool IsEnabled()
+	{
+		return Utils::g_enabled.load(std::memory_order_relaxed);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	void Start()
+	{
+		Utils::g_captureStart = std::chrono::steady_clock::now();
+		Utils::GetThreadBuffer(); //the thread starting the capture gets the first id
+		Utils::g_enabled.store(true, std::memory_order_relaxed);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool Stop(const char* filename)
+	{
+		Utils::g_enabled.store(false, std::memory_order_relaxed);
+
+		//All worker threads are expected to be idle at this point, the pool workers keep their buffers between jobs
+		IO::TextOutputStream stream(filename);
+		if (!stream.IsValid())
+		{
+			return false;
+		}
+
+		U64 droppedZones = 0u;
+		bool isFirst = true;
+		stream.Append("{\"traceEvents\":[");
+
+		std::lock_guard<std::mutex> lock(Utils::g_registry.mutex);
+		for (const Utils::ThreadBuffer* buffer : Utils::g_registry.buffers)
+		{
+			Utils::WriteThreadName(stream, buffer->threadId, isFirst);
+
+			const U64 first = buffer->count > Utils::RING_CAPACITY? buffer->count - Utils::RING_CAPACITY : 0u;
+			droppedZones += first;
+
+			for (U64 i = first; i < buffer->count; ++i)
+			{
+				Utils::WriteTraceEvent(stream, buffer->records[i & Utils::RING_MASK], buffer->threadId, isFirst);
+			}
+		}
+
+		stream.Append("\n]}");
+
+		if (droppedZones > 0u)
+		{
+			LOG_INFO("Self trace ring buffers overflowed, %llu zones were dropped.", droppedZones);
+		}
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	Zone::Zone(const char* name)
+		: m_name(IsEnabled()? name : nullptr)
+		, m_start(m_name? Utils::Now() : 0u)
+	{}
+
+	// -----------------------------------------------------------------------------------------------------------
+	Zone::~Zone()
+	{
+		if (m_name)
+		{
+			Utils::ThreadBuffer& buffer = Utils::GetThreadBuffer();
+			buffer.records[buffer.count & Utils::RING_MASK] = Utils::Record{ m_name, m_start, Utils::Now() };
+			++buffer.count;
+		}
+	}
+}
+
+#endif //USE_PROFILER
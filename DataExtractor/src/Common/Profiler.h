@@ -0,0 +1,53 @@
+#pragma once
+
+// Self profiling for the extractor, zones are only compiled in when USE_PROFILER is defined
+// When compiled in, zones are only recorded once the capture has been started ( -selftrace )
+
+#ifdef USE_PROFILER
+
+#include "BasicTypes.h"
+
+namespace Profiler
+{
+	bool IsAvailable();
+	bool IsEnabled();
+
+	void Start();
+	bool Stop(const char* filename); //writes all recorded zones as a chrome trace
+
+	// -----------------------------------------------------------------------------------------------------------
+	class Zone
+	{
+	public:
+		explicit Zone(const char* name);
+		~Zone();
+
+		Zone(const Zone& input) = delete;
+		Zone(Zone&& input) = delete;
+		Zone& operator = (const Zone& input) = delete;
+		Zone& operator = (Zone&& input) = delete;
+
+	private:
+		const char* m_name;
+		U64         m_start;
+	};
+}
+
+#define PROFILER_CONCAT_IMPL(a,b) a##b
+#define PROFILER_CONCAT(a,b) PROFILER_CONCAT_IMPL(a,b)
+#define PROFILE_ZONE(name) Profiler::Zone PROFILER_CONCAT(profilerZone,__LINE__)(name)
+
+#else
+
+namespace Profiler
+{
+	inline bool IsAvailable(){ return false; }
+	inline bool IsEnabled(){ return false; }
+
+	inline void Start(){}
+	inline bool Stop(const char*){ return false; }
+}
+
+#define PROFILE_ZONE(name)
+
+#endif //USE_PROFILER
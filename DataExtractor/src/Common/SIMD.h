@@ -0,0 +1,44 @@
+#pragma once
+
+#include "BasicTypes.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_USE_SSE2
+#endif
+
+#ifdef SIMD_USE_SSE2
+
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace SIMD
+{ 
+    constexpr U64 BLOCK_SIZE = 16u;
+
+    // -----------------------------------------------------------------------------------------------------------
+    inline U32 FirstSetBit(const U32 mask)
+    { 
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // -----------------------------------------------------------------------------------------------------------
+    inline __m128i Load(const char* str) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(str)); }
+    inline __m128i LoadAligned(const char* str) { return _mm_load_si128(reinterpret_cast<const __m128i*>(str)); }
+    inline void Store(char* str, const __m128i value) { _mm_storeu_si128(reinterpret_cast<__m128i*>(str), value); }
+
+    // -----------------------------------------------------------------------------------------------------------
+    inline U32 FindMask(const __m128i block, const char c)
+    { 
+        return static_cast<U32>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c))));
+    }
+}
+
+#endif //SIMD_USE_SSE2
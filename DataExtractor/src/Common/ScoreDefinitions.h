@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BasicTypes.h"
+#include "../fastl/arena.h"
 #include "../fastl/vector.h"
 #include "../fastl/string.h"
 #include "../fastl/unordered_map.h"
@@ -84,6 +85,9 @@ struct CompileData
         , selfMaxId(InvalidCompileId)
         , count(0u)
         , unitCount(0u)
+        , p50(0u)
+        , p90(0u)
+        , p99(0u)
     {}
 
     CompileData(const U64 _nameHash)
@@ -98,6 +102,9 @@ struct CompileData
         , selfMaxId(InvalidCompileId)
         , count(0u)
         , unitCount(0u)
+        , p50(0u)
+        , p90(0u)
+        , p99(0u)
     {}
 
     U64 nameHash; 
@@ -111,6 +118,43 @@ struct CompileData
     U32 selfMaxId;
     U32 count;
     U32 unitCount;
+    U32 p50; //filled by the ScoreProcessor from the duration histogram
+    U32 p90;
+    U32 p99;
+};
+
+// Log bucketed duration histogram, 4 buckets per power of two ( under 10% error on the quantiles )
+// Most entries only see a handful of durations, the first buckets live inline and the full bucket array is only taken
+// from the category pool once the entry spans more buckets or a count outgrows 16 bits. Mergeable by adding the buckets together
+struct CompileHistogram
+{ 
+    enum : U32 
+    { 
+        SUB_BUCKET_BITS = 2u, 
+        NUM_BUCKETS     = (32u - SUB_BUCKET_BITS + 1u) << SUB_BUCKET_BITS,
+        INLINE_BUCKETS  = 6u,
+        NO_DENSE        = 0xffffffff,
+    };
+
+    CompileHistogram()
+        : denseOffset(NO_DENSE)
+        , inlineCounts{}
+        , inlineBuckets{}
+        , numInline(0u)
+    {}
+
+    U32 denseOffset; //first of the NUM_BUCKETS counts in the pool once dense
+    U16 inlineCounts[INLINE_BUCKETS];
+    U8  inlineBuckets[INLINE_BUCKETS];
+    U8  numInline;
+};
+
+static_assert(CompileHistogram::NUM_BUCKETS <= 256u, "the inline bucket ids are stored as U8");
+
+struct CompileHistograms
+{ 
+    fastl::vector<CompileHistogram> entries;
+    fastl::vector<U32>              denseBuckets; //pool of NUM_BUCKETS blocks for the entries that outgrew the inline buckets
 };
 
 struct CompileEvent
@@ -170,6 +214,45 @@ struct CompileIncluder
 
 using TIndexDataDictionary = fastl::unordered_map<U64,U32>;
 
+// Append only compressed bitset over the unit ids, the units are processed in order so new ids always go last
+// Runs of fully set 64 unit words are stored as a count, anything else as a literal word
+struct CompileUnitSet
+{ 
+    struct Chunk
+    { 
+        U32 firstWord; //first word of the full run
+        U32 fullWords; //number of fully set words before the literal one
+        U64 literal;   //word at firstWord + fullWords
+    };
+
+    fastl::vector<Chunk> chunks;
+};
+
+// Include graph derived costs, one entry per include global
+struct CompileIncludeCost
+{ 
+    CompileIncludeCost()
+        : exclusive(0u)
+        , rebuildCost(0u)
+        , rebuildUnits(0u)
+    {}
+
+    U64            exclusive;    //time of the includes only reachable through this one ( dominator tree ), accumulated over all units
+    U64            rebuildCost;  //compilation time of all units including this one transitively
+    U32            rebuildUnits; //number of units including this one transitively
+    CompileUnitSet units;        //NOT EXPORTED - units including this one transitively
+};
+
+// Include graph of the unit being processed, node 0 is the unit itself
+struct CompileIncludeGraph
+{ 
+    fastl::vector<U32> nodeIncludeIds; //include global id of each node
+    fastl::vector<U64> nodeCosts;      //self time of each node in this unit
+    fastl::vector<U64> edges;          //( includer node << 32 ) | included node
+    fastl::vector<U32> nodeIds;        //node of each include global, only valid if its mark matches the unit epoch
+    fastl::vector<U32> nodeMarks;
+};
+
 struct CompileFolder
 {
     CompileFolder(){}
@@ -184,44 +267,176 @@ struct CompileFolder
     fastl::vector<U32>     includeIds;
 };
 
+// Namespace or class scope of the symbol globals qualified names, node 0 is the global scope
+struct CompileScope
+{
+    CompileScope()
+        : accumulated()
+        , selfAccumulated()
+        , count()
+    {}
+
+    CompileScope(const char* nameStr, size_t length)
+        : name(nameStr,length)
+        , accumulated()
+        , selfAccumulated()
+        , count()
+    {}
+
+    fastl::string        name;
+    TIndexDataDictionary children;
+    U64                  accumulated[ToUnderlying(CompileCategory::GatherFull)];     //per symbol category of all symbols inside this scope ( the include slot is unused )
+    U64                  selfAccumulated[ToUnderlying(CompileCategory::GatherFull)];
+    U32                  count[ToUnderlying(CompileCategory::GatherFull)];
+};
+
 struct CompileSession
 {
     CompileSession()
         : fullDuration(0u)
+        , totalFiles(0u)
+        , sampledFiles(0u)
     {}
 
+    bool IsSampled() const { return totalFiles != 0u; }
+
     U64 totals[ToUnderlying(CompileCategory::DisplayCount)];
     U64 fullDuration;
+
+    //sampling mode, the totals are extrapolated from the sampled files
+    U32 totalFiles;
+    U32 sampledFiles;
+    U64 totalsMargin[ToUnderlying(CompileCategory::DisplayCount)]; //95% confidence interval half width
+};
+
+// Number of compiling units over the session, computed from the unit start times and durations
+struct CompileConcurrency
+{ 
+    enum : U32 { NUM_SLICES = 256u };
+
+    CompileConcurrency()
+        : peak(0u)
+        , sliceDuration(0u)
+        , tailStart(0u)
+    {}
+
+    U32                peak;
+    fastl::vector<U64> levelDurations; //time spent with each number of active units ( 0 means idle )
+    U64                sliceDuration;
+    fastl::vector<U64> sliceActivity;  //accumulated active unit time per slice, divided by the slice duration gives the average concurrency
+    U64                tailStart;      //last moment the build had at least half its peak concurrency
+    fastl::vector<U32> tailUnitIds;    //units still compiling during the tail, sorted by finish time
+};
+
+// Build system step ( .ninja_log entry ), times in microseconds from the build start
+struct CompileBuildStep
+{ 
+    CompileBuildStep()
+        : start(0u)
+        , end(0u)
+        , slack(0u)
+        , unitId(InvalidCompileId)
+        , critical(false)
+    {}
+
+    fastl::string output;
+    U64           start;
+    U64           end;
+    U64           slack;    //how much this step can be delayed before it can delay the critical path
+    U32           unitId;   //InvalidCompileId when the output is not a traced unit ( links, custom commands... )
+    bool          critical;
+};
+
+using TCompileBuildSteps = fastl::vector<CompileBuildStep>;
+
+struct CompileBuildLog
+{ 
+    CompileBuildLog()
+        : duration(0u)
+    {}
+
+    TCompileBuildSteps steps;
+    fastl::vector<U32> criticalPath; //step ids from the build start to its end
+    U64                duration;
 };
 
 using TCompileDatas            = fastl::vector<CompileData>;
 using TCompileUnits            = fastl::vector<CompileUnit>;
 using TCompileIncluders        = fastl::vector<CompileIncluder>;
-using TCompileEvents           = fastl::vector<CompileEvent>;
-using TCompileEventTracks      = fastl::vector<TCompileEvents>;
+using TCompileIncludeCosts     = fastl::vector<CompileIncludeCost>;
+using TCompileEvents           = fastl::vector<CompileEvent, fastl::ArenaAllocator<CompileEvent>>;
+using TCompileEventTracks      = fastl::vector<TCompileEvents, fastl::ArenaAllocator<TCompileEvents>>;
 using TCompileStrings          = fastl::unordered_map<U64,fastl::string>;
+using TDemangledNames          = fastl::unordered_map<U64,U64>;
 using TCompileFolders          = fastl::vector<CompileFolder>;
+using TCompileScopes           = fastl::vector<CompileScope>;
 using TTags                    = fastl::vector<U64>;
+using TUnitMarks               = fastl::vector<U32>;
+using TSampleMargins           = fastl::vector<U64>;
+using TSampleSums              = fastl::vector<U64>;
+using TSampleSquares           = fastl::vector<double>;
+
+// Space saving summary for a global category with a bounded number of entries ( heavy hitters mode )
+struct CompileDataSketch
+{
+    fastl::vector<U32>           heap;      //entry ids as a min heap by accumulated time, the root is the next one to be replaced
+    fastl::vector<U32>           heapIndex; //heap position of each entry
+    fastl::vector<U64>           errors;    //maximum overestimation of the accumulated time of each entry
+    fastl::vector<fastl::string> names;     //only the tracked entries keep their names
+};
 
 struct ScoreTimeline
 { 
+    //the tracks can live in a scratch arena when the timeline is discarded right after being processed
+    explicit ScoreTimeline(fastl::Arena* arena = nullptr)
+        : tracks(TCompileEventTracks::allocator_type(arena))
+        , nameHash(0ull)
+    {}
+
     TCompileEventTracks tracks;
     U64                 nameHash;
 };
 
 struct ScoreData
 { 
+    ScoreData()
+        : globalsCapacity(0u)
+    {}
+
     //exported data
-    CompileSession    session;
-    TCompileUnits     units;
-    TCompileDatas     globals[ToUnderlying(CompileCategory::GatherFull)];
-    TCompileIncluders includers;
-    TCompileStrings   strings;
-    TCompileFolders   folders;
-    TTags             otherTags;
+    CompileSession     session;
+    CompileConcurrency concurrency;
+    CompileBuildLog    buildLog;
+    TCompileUnits      units;
+    TCompileDatas      globals[ToUnderlying(CompileCategory::GatherFull)];
+    TCompileIncluders  includers;
+    TCompileIncludeCosts includeCosts;
+    TCompileStrings    strings;
+    TCompileFolders    folders;
+    TCompileScopes     scopes;
+    TTags              otherTags;
+    TCompileDatas      otherDatas; //timings of each other tag, same order as the tags
+    TCompileDatas      passes;     //backend passes, RunPass by pass name and the pass managers by event name
+    TSampleMargins     globalsMargin[ToUnderlying(CompileCategory::GatherFull)]; //sampling mode, 95% confidence interval half width of each accumulated value
 
     //helper data
     TIndexDataDictionary globalsDictionary[ToUnderlying(CompileCategory::GatherFull)];
     TIndexDataDictionary otherTagsDictionary;
+    TIndexDataDictionary passesDictionary;
+    TUnitMarks           otherDatasUnitMarks;
+    TUnitMarks           passesUnitMarks;
+    TUnitMarks           globalsUnitMarks[ToUnderlying(CompileCategory::GatherFull)]; //last unit epoch that visited each global entry
+    CompileHistograms    globalsHistograms[ToUnderlying(CompileCategory::GatherFull)]; //duration distribution of each global entry
+    CompileIncludeGraph  includeGraph; //includes of the unit being processed
+    TDemangledNames      demangledNames; //mangled name hash -> symbol name hash, the same backend functions show up in every unit
+
+    //heavy hitters mode
+    U32                  globalsCapacity; //0 means exact globals
+    CompileDataSketch    globalsSketch[ToUnderlying(CompileCategory::GatherFull)];
+    TCompileStrings      transientStrings; //symbol names of the unit being processed, only the tracked ones are kept
+
+    //sampling mode
+    TSampleSums          globalsUnitSums[ToUnderlying(CompileCategory::GatherFull)];    //contribution of the unit being processed to each entry
+    TSampleSquares       globalsUnitSquares[ToUnderlying(CompileCategory::GatherFull)]; //sum of the squared unit contributions of each entry
 };
 
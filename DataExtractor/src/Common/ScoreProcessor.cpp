@@ -1,49 +1,508 @@
+#include <cmath>
+
+#include "../Common/BuildLog.h"
 #include "../Common/Context.h"
 #include "../Common/CRC64.h"
 #include "../Common/ScoreDefinitions.h"
+#include "../Common/ScoreUtils.h"
+#include "../Common/Simulator.h"
 #include "../Common/StringUtils.h"
+#include "../Common/Suggestions.h"
+#include "../Common/Threading.h"
 #include "../fastl/algorithm.h"
 #include "../fastl/memory.h"
-#include "../fastl/unordered_set.h"
 
 #include "IOStream.h"
+#include "Profiler.h"
+#include "ScoreProcessor.h"
 #include "CommandLine.h"
 
 namespace CompileScore
 { 
-	typedef fastl::unordered_set<U64> TUniqueElementsSet;
-
 	namespace Utils
 	{ 
 		// -----------------------------------------------------------------------------------------------------------
 		enum : U32 { kInvalidIndex = 0xffffffff };
 
+		using TEventStack  = fastl::vector<CompileEvent*, fastl::ArenaAllocator<CompileEvent*>>;
+		using TDataIdStack = fastl::vector<U32, fastl::ArenaAllocator<U32>>;
+
+		using ScoreUtils::Min;
+		using ScoreUtils::Max;
+		using ScoreUtils::PopCount;
+		using ScoreUtils::CountTrailingZeros;
+
+		// -----------------------------------------------------------------------------------------------------------
+		U32 GetUnitEpoch(const CompileUnit& unit)
+		{
+			//unit ids are unique per extraction, offset by one so 0 remains as the 'never visited' mark
+			return unit.unitId + 1u;
+		}
+
 		// -----------------------------------------------------------------------------------------------------------
-		template <typename T> inline constexpr T Min(const T a, const T b) { return a < b? a : b; }
-		template <typename T> inline constexpr T Max(const T a, const T b) { return a < b? b : a; }
+		// Path split in folders, resolved ahead of time so the folder tree insertion only deals with the hashes
+		struct FolderPath
+		{
+			FolderPath() : path(nullptr) {}
+
+			const char*        path;
+			fastl::vector<U64> folderHashes;
+		};
 
 		// -----------------------------------------------------------------------------------------------------------
-		U64 GetUniqueElementHash(const CompileCategory category, const U32 index)
+		void ResolveFolderPath(FolderPath& output, const TCompileStrings& strings, const U64 nameHash)
 		{
-			return (((U64)category) << 32) | index;
+			TCompileStrings::const_iterator found = strings.find(nameHash);
+			if (found == strings.end())
+			{
+				return;
+			}
+
+			output.path = found->second.c_str();
+
+			const char* folderStart = output.path;
+			for (const char* folderEnd = output.path; *folderEnd != '\0'; ++folderEnd)
+			{
+				if (*folderEnd == '/' || *folderEnd == '\\')
+				{
+					output.folderHashes.push_back(Hash::AppendToCRC64(0ull, folderStart, folderEnd - folderStart));
+					folderStart = folderEnd + 1;
+				}
+			}
 		}
-	}
 
-	// -----------------------------------------------------------------------------------------------------------
-	U64 StoreString(ScoreData& scoreData, const fastl::string& str)
-	{
-		const U64 strHash = Hash::AppendToCRC64(0ull, str.c_str(), str.length() );
-		if (strHash)
+		// -----------------------------------------------------------------------------------------------------------
+		// Qualified symbol name split in scopes, resolved ahead of time so the scope tree insertion only deals with the hashes
+		struct ScopePath
+		{
+			struct Scope
+			{
+				U64 hash;
+				U32 start;
+				U32 length;
+			};
+
+			ScopePath() : name(nullptr) {}
+
+			const char*          name;
+			fastl::vector<Scope> scopes;
+		};
+
+		// -----------------------------------------------------------------------------------------------------------
+		// Splits on the '::' outside brackets, the template arguments are not part of the scope name ( 'std::vector<int>::push_back' -> std, vector )
+		void ResolveScopePath(ScopePath& output, const TCompileStrings& strings, const U64 nameHash)
+		{
+			TCompileStrings::const_iterator found = strings.find(nameHash);
+			if (found == strings.end())
+			{
+				return;
+			}
+
+			const char* name = found->second.c_str();
+			output.name = name;
+
+			U32 depth = 0u;
+			U32 scopeStart = 0u;
+			U32 scopeEnd = 0u;
+			for (U32 i = 0u; name[i] != '\0'; ++i)
+			{
+				const char c = name[i];
+				if (depth == 0u && i == scopeStart && StringUtils::IsOperatorName(name + i))
+				{
+					//operator names are always the symbol itself and their brackets are not balanced
+					break;
+				}
+
+				if (c == '<' || c == '(' || c == '[' || c == '{')
+				{
+					scopeEnd = depth == 0u && c == '<' && scopeEnd == 0u ? i : scopeEnd;
+					++depth;
+				}
+				else if (c == '>' || c == ')' || c == ']' || c == '}')
+				{
+					depth -= depth > 0u ? 1u : 0u;
+				}
+				else if (depth == 0u && c == ':' && name[i + 1u] == ':')
+				{
+					const U32 length = (scopeEnd > scopeStart ? scopeEnd : i) - scopeStart;
+					if (length > 0u)
+					{
+						output.scopes.push_back({ Hash::AppendToCRC64(0ull, name + scopeStart, length), scopeStart, length });
+					}
+
+					scopeStart = i + 2u;
+					scopeEnd = 0u;
+					++i;
+				}
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U64 StoreString(TCompileStrings& strings, const char* str, size_t length)
+		{
+			const U64 strHash = Hash::AppendToCRC64(0ull, str, length);
+			if (strHash && strings.find(strHash) == strings.end())
+			{
+				//only build the string copy the first time we see it
+				strings.insert(TCompileStrings::value_type(strHash, fastl::string(str, length)));
+			}
+			return strHash;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U64 StoreSymbolString(TCompileStrings& strings, const char* str, size_t length)
+		{
+			ExportParams* exportParams = Context::Get<ExportParams>();
+			if (exportParams && exportParams->templateArgs == ExportParams::TemplateArgs::Keep) 
+			{
+				return StoreString(strings, str, length);
+			}
+			else
+			{
+				fastl::string symbolName(str, length);
+				StringUtils::CollapseTemplates(symbolName);
+				return StoreString(strings, symbolName.c_str(), symbolName.length());
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		TCompileStrings& GetSymbolStrings(ScoreData& scoreData)
+		{
+			//in heavy hitters mode the names only outlive the unit being processed if their entry gets tracked
+			ExportParams* exportParams = Context::Get<ExportParams>();
+			return exportParams && exportParams->globals == ExportParams::Globals::HeavyHitters ? scoreData.transientStrings : scoreData.strings;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// The backend events carry mangled names, each one is only demangled the first time it is found
+		U64 StoreMangledSymbolString(ScoreData& scoreData, const char* str, size_t length)
+		{
+			if (length < 2u || str[0] != '_' || str[1] != 'Z')
+			{
+				return StoreSymbolString(GetSymbolStrings(scoreData), str, length);
+			}
+
+			//the cached names are stored next to the other symbol names, in heavy hitters mode both are cleared after each unit
+			const U64 mangledHash = Hash::AppendToCRC64(0ull, str, length);
+			TDemangledNames::const_iterator found = scoreData.demangledNames.find(mangledHash);
+			if (found != scoreData.demangledNames.end())
+			{
+				return found->second;
+			}
+
+			fastl::string symbolName(str, length);
+			StringUtils::Demangle(symbolName);
+
+			ExportParams* exportParams = Context::Get<ExportParams>();
+			if (exportParams == nullptr || exportParams->templateArgs != ExportParams::TemplateArgs::Keep)
+			{
+				StringUtils::CollapseTemplates(symbolName);
+			}
+
+			const U64 nameHash = StoreString(GetSymbolStrings(scoreData), symbolName.c_str(), symbolName.length());
+			scoreData.demangledNames.insert(TDemangledNames::value_type(mangledHash, nameHash));
+			return nameHash;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		const fastl::string* FindSymbolString(const ScoreData& scoreData, const U64 nameHash)
+		{
+			TCompileStrings::const_iterator found = scoreData.transientStrings.find(nameHash);
+			if (found != scoreData.transientStrings.end()) return &found->second;
+
+			found = scoreData.strings.find(nameHash);
+			return found != scoreData.strings.end() ? &found->second : nullptr;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void ResetIncludeGraph(CompileIncludeGraph& graph)
+		{
+			graph.nodeIncludeIds.clear();
+			graph.nodeCosts.clear();
+			graph.edges.clear();
+
+			//the unit root
+			graph.nodeIncludeIds.push_back(InvalidCompileId);
+			graph.nodeCosts.push_back(0u);
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U32 GetIncludeNode(CompileIncludeGraph& graph, const U32 includeId, const U32 unitEpoch)
+		{
+			if (includeId >= graph.nodeIds.size())
+			{
+				const size_t size = Max<size_t>(includeId + 1u, graph.nodeIds.size() * 2u);
+				graph.nodeIds.resize(size);
+				graph.nodeMarks.resize(size);
+			}
+
+			if (graph.nodeMarks[includeId] != unitEpoch)
+			{
+				graph.nodeMarks[includeId] = unitEpoch;
+				graph.nodeIds[includeId] = static_cast<U32>(graph.nodeIncludeIds.size());
+				graph.nodeIncludeIds.push_back(includeId);
+				graph.nodeCosts.push_back(0u);
+			}
+
+			return graph.nodeIds[includeId];
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void AddToUnitSet(CompileUnitSet& unitSet, const U32 unitId)
+		{
+			const U32 wordIndex = unitId >> 6u;
+			const U64 bit = 1ull << (unitId & 63u);
+
+			if (!unitSet.chunks.empty())
+			{
+				CompileUnitSet::Chunk& last = unitSet.chunks.back();
+				const U32 literalWord = last.firstWord + last.fullWords;
+				if (literalWord == wordIndex)
+				{
+					last.literal |= bit;
+					return;
+				}
+
+				if (last.literal == ~0ull && literalWord + 1u == wordIndex)
+				{
+					//the literal got full, extend the run
+					++last.fullWords;
+					last.literal = bit;
+					return;
+				}
+			}
+
+			unitSet.chunks.push_back({ wordIndex, 0u, bit });
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U32 HighestBit(U32 value)
+		{
+			U32 bit = 0u;
+			if (value >= (1u << 16u)) { value >>= 16u; bit += 16u; }
+			if (value >= (1u << 8u))  { value >>= 8u;  bit += 8u;  }
+			if (value >= (1u << 4u))  { value >>= 4u;  bit += 4u;  }
+			if (value >= (1u << 2u))  { value >>= 2u;  bit += 2u;  }
+			if (value >= (1u << 1u))  { bit += 1u; }
+			return bit;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U32 GetHistogramBucket(const U32 duration)
+		{
+			constexpr U32 subBuckets = 1u << CompileHistogram::SUB_BUCKET_BITS;
+			if (duration < subBuckets)
+			{
+				//exact buckets for the smallest values
+				return duration;
+			}
+
+			//the highest bit picks the power of two, the following bits split it linearly
+			const U32 exponent = HighestBit(duration) - CompileHistogram::SUB_BUCKET_BITS;
+			const U32 subBucket = (duration >> exponent) & (subBuckets - 1u);
+			return ((exponent + 1u) << CompileHistogram::SUB_BUCKET_BITS) + subBucket;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void SpillHistogram(CompileHistograms& histograms, CompileHistogram& histogram)
+		{
+			histogram.denseOffset = static_cast<U32>(histograms.denseBuckets.size());
+			histograms.denseBuckets.resize(histograms.denseBuckets.size() + CompileHistogram::NUM_BUCKETS);
+
+			U32* dense = &histograms.denseBuckets[histogram.denseOffset];
+			for (U32 i = 0u; i < histogram.numInline; ++i)
+			{
+				dense[histogram.inlineBuckets[i]] = histogram.inlineCounts[i];
+			}
+			histogram.numInline = 0u;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void AddHistogramSample(CompileHistograms& histograms, const U32 index, const U32 bucket)
+		{
+			CompileHistogram& histogram = histograms.entries[index];
+			if (histogram.denseOffset == CompileHistogram::NO_DENSE)
+			{
+				U32 slot = 0u;
+				for (; slot < histogram.numInline && histogram.inlineBuckets[slot] != bucket; ++slot) {}
+
+				if (slot < histogram.numInline && histogram.inlineCounts[slot] < 0xffff)
+				{
+					++histogram.inlineCounts[slot];
+					return;
+				}
+
+				if (slot == histogram.numInline && slot < CompileHistogram::INLINE_BUCKETS)
+				{
+					histogram.inlineBuckets[slot] = static_cast<U8>(bucket);
+					histogram.inlineCounts[slot] = 1u;
+					++histogram.numInline;
+					return;
+				}
+
+				SpillHistogram(histograms, histogram);
+			}
+
+			++histograms.denseBuckets[histogram.denseOffset + bucket];
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void ResetHistogram(CompileHistograms& histograms, const U32 index)
+		{
+			//a dense block stays with the slot for the next entry, the pool can't grow past the heavy hitters capacity
+			CompileHistogram& histogram = histograms.entries[index];
+			histogram.numInline = 0u;
+			if (histogram.denseOffset != CompileHistogram::NO_DENSE)
+			{
+				fastl::memset(&histograms.denseBuckets[histogram.denseOffset], 0, sizeof(U32) * CompileHistogram::NUM_BUCKETS);
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void GetHistogramBuckets(const CompileHistograms& histograms, const U32 index, U32* buckets)
+		{
+			const CompileHistogram& histogram = histograms.entries[index];
+			if (histogram.denseOffset != CompileHistogram::NO_DENSE)
+			{
+				for (U32 i = 0u; i < CompileHistogram::NUM_BUCKETS; ++i)
+				{
+					buckets[i] = histograms.denseBuckets[histogram.denseOffset + i];
+				}
+				return;
+			}
+
+			fastl::memset(buckets, 0, sizeof(U32) * CompileHistogram::NUM_BUCKETS);
+			for (U32 i = 0u; i < histogram.numInline; ++i)
+			{
+				buckets[histogram.inlineBuckets[i]] = histogram.inlineCounts[i];
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U32 GetHistogramQuantile(const U32* buckets, const CompileData& data, const U64 totalCount, const double quantile)
+		{
+			//rank of the element we are looking for
+			const U64 rank = Max<U64>(static_cast<U64>(quantile * static_cast<double>(totalCount) + 0.999999), 1ull);
+
+			constexpr U32 subBuckets = 1u << CompileHistogram::SUB_BUCKET_BITS;
+			U64 seen = 0u;
+			for (U32 i = 0; i < CompileHistogram::NUM_BUCKETS; ++i)
+			{
+				seen += buckets[i];
+				if (seen >= rank)
+				{
+					if (i < subBuckets)
+					{
+						return i;
+					}
+
+					//middle of the bucket, the exact min and max clamp the open ends
+					const U32 exponent = (i >> CompileHistogram::SUB_BUCKET_BITS) - 1u;
+					const U64 lower = static_cast<U64>(subBuckets + (i & (subBuckets - 1u))) << exponent;
+					const U64 upper = lower + (1ull << exponent);
+					const U64 middle = (lower + upper) >> 1u;
+					return static_cast<U32>(Min<U64>(Max<U64>(middle, data.minimum), data.maximum));
+				}
+			}
+
+			return data.maximum;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		bool IsSketchCategory(const CompileCategory category)
+		{
+			//includes are always exact, the includers and folders depend on them
+			return category > CompileCategory::Include && category < CompileCategory::GatherFull;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		bool IsPassCategory(const CompileCategory category)
+		{
+			return category >= CompileCategory::RunPass && category < CompileCategory::Invalid;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// Same bookkeeping as the gathered globals minus the histograms, these events are outside the unit totals
+		void AccumulateEventData(CompileData& compileData, U32& unitMark, const CompileEvent& element, const CompileUnit& unit)
+		{
+			compileData.accumulated += element.duration;
+			compileData.selfAccumulated += element.selfDuration;
+			compileData.minimum = Min(element.duration, compileData.minimum);
+
+			if (element.duration >= compileData.maximum)
+			{
+				compileData.maximum = element.duration;
+				compileData.maxId = unit.unitId;
+			}
+
+			if (element.selfDuration >= compileData.selfMaximum)
+			{
+				compileData.selfMaximum = element.selfDuration;
+				compileData.selfMaxId = unit.unitId;
+			}
+
+			++compileData.count;
+
+			const U32 unitEpoch = GetUnitEpoch(unit);
+			if (unitMark != unitEpoch)
+			{
+				unitMark = unitEpoch;
+				++compileData.unitCount;
+				compileData.unitAccumulated += unit.values[ToUnderlying(CompileCategory::ExecuteCompiler)];
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void SketchSwap(CompileDataSketch& sketch, const U32 a, const U32 b)
+		{
+			const U32 entryA = sketch.heap[a];
+			const U32 entryB = sketch.heap[b];
+			sketch.heap[a] = entryB;
+			sketch.heap[b] = entryA;
+			sketch.heapIndex[entryB] = a;
+			sketch.heapIndex[entryA] = b;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void SketchSiftUp(CompileDataSketch& sketch, const TCompileDatas& global, U32 position)
+		{
+			while (position > 0u)
+			{
+				const U32 parent = (position - 1u) >> 1u;
+				if (global[sketch.heap[parent]].accumulated <= global[sketch.heap[position]].accumulated) break;
+				SketchSwap(sketch, parent, position);
+				position = parent;
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void SketchSiftDown(CompileDataSketch& sketch, const TCompileDatas& global, U32 position)
 		{
-			scoreData.strings.insert(TCompileStrings::value_type(strHash, str));
+			const U32 size = static_cast<U32>(sketch.heap.size());
+			for (;;)
+			{
+				const U32 left = (position << 1u) + 1u;
+				const U32 right = left + 1u;
+				U32 lightest = position;
+				if (left < size && global[sketch.heap[left]].accumulated < global[sketch.heap[lightest]].accumulated) lightest = left;
+				if (right < size && global[sketch.heap[right]].accumulated < global[sketch.heap[lightest]].accumulated) lightest = right;
+				if (lightest == position) break;
+				SketchSwap(sketch, lightest, position);
+				position = lightest;
+			}
 		}
-		return strHash;
 	}
 
 	// -----------------------------------------------------------------------------------------------------------
 	U64 StoreString(ScoreData& scoreData, const char* str, size_t length)
 	{
-		return StoreString(scoreData, fastl::string(str, length));
+		return Utils::StoreString(scoreData.strings, str, length);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	U64 StoreString(ScoreData& scoreData, const fastl::string& str)
+	{
+		return StoreString(scoreData, str.c_str(), str.length());
 	}
 
 	// -----------------------------------------------------------------------------------------------------------
@@ -65,17 +524,7 @@ namespace CompileScore
 	// -----------------------------------------------------------------------------------------------------------
 	U64 StoreSymbolString(ScoreData& scoreData, const char* str, size_t length)
 	{
-		ExportParams* exportParams = Context::Get<ExportParams>();
-		if (exportParams && exportParams->templateArgs == ExportParams::TemplateArgs::Keep) 
-		{
-			return StoreString(scoreData, str, length);
-		}
-		else
-		{
-			fastl::string symbolName(str, length);
-			StringUtils::CollapseTemplates(symbolName);
-			return StoreString(scoreData, symbolName);
-		}
+		return Utils::StoreSymbolString(scoreData.strings, str, length);
 	}
 
 	// -----------------------------------------------------------------------------------------------------------
@@ -116,9 +565,11 @@ namespace CompileScore
 		case CompileCategory::InstantiateConcept:
 		case CompileCategory::InstantiateVariable:
 		case CompileCategory::InstantiateFunction:
+			return Utils::StoreSymbolString(Utils::GetSymbolStrings(scoreData), str, length);
+
 		case CompileCategory::CodeGenFunction:
 		case CompileCategory::OptimizeFunction:
-			return StoreSymbolString(scoreData, str, length);
+			return Utils::StoreMangledSymbolString(scoreData, str, length);
 
 		default: 
 			return StoreString(scoreData, str, length); 
@@ -144,6 +595,8 @@ namespace CompileScore
 			//the element got inserted
 			element.nameId = nextIndex;
 			scoreData.otherTags.emplace_back( element.nameHash );
+			scoreData.otherDatas.emplace_back( element.nameHash );
+			scoreData.otherDatasUnitMarks.emplace_back( 0u );
 
 			return nextIndex;
 		}
@@ -152,6 +605,20 @@ namespace CompileScore
 		return element.nameId;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------
+	U32 CreatePassEntry(ScoreData& scoreData, const CompileEvent& element)
+	{ 
+		const U32 nextIndex = static_cast<U32>(scoreData.passes.size());
+		auto const& result = scoreData.passesDictionary.insert(TIndexDataDictionary::value_type(element.nameHash, nextIndex));
+		if (result.second)
+		{ 
+			scoreData.passes.emplace_back(element.nameHash);
+			scoreData.passesUnitMarks.emplace_back(0u);
+		}
+
+		return result.first->second;
+	}
+
 	// -----------------------------------------------------------------------------------------------------------
 	U32 CreateGlobalEntry(ScoreData& scoreData, CompileEvent& element)
 	{ 
@@ -166,11 +633,14 @@ namespace CompileScore
 			//the element got inserted
 			element.nameId = nextIndex;
 			global.emplace_back(element.nameHash);
+			scoreData.globalsUnitMarks[globalIndex].emplace_back(0u);
+			scoreData.globalsHistograms[globalIndex].entries.emplace_back();
 
 			//for now we only have users entry for Includes
 			if( element.category == CompileCategory::Include )
 			{
 				scoreData.includers.emplace_back();
+				scoreData.includeCosts.emplace_back();
 			}
 
 			return nextIndex;
@@ -180,6 +650,64 @@ namespace CompileScore
 		return element.nameId;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------
+	// Space saving: once the category is full the lightest entry gets replaced and its time is carried over as the error bound
+	U32 CreateSketchEntry(ScoreData& scoreData, CompileEvent& element)
+	{ 
+		const CompileCategoryType globalIndex = ToUnderlying(element.category);
+		TCompileDatas& global = scoreData.globals[globalIndex];
+		TIndexDataDictionary& dictionary = scoreData.globalsDictionary[globalIndex];
+		CompileDataSketch& sketch = scoreData.globalsSketch[globalIndex];
+
+		//the entry ids are reused, the timelines can't reference them
+		element.nameId = InvalidCompileId;
+
+		TIndexDataDictionary::iterator found = dictionary.find(element.nameHash);
+		if (found != dictionary.end())
+		{ 
+			return found->second;
+		}
+
+		const fastl::string* name = Utils::FindSymbolString(scoreData, element.nameHash);
+
+		if (global.size() < scoreData.globalsCapacity)
+		{ 
+			const U32 entryIndex = static_cast<U32>(global.size());
+			dictionary.insert(TIndexDataDictionary::value_type(element.nameHash, entryIndex));
+			global.emplace_back(element.nameHash);
+			scoreData.globalsUnitMarks[globalIndex].emplace_back(0u);
+			scoreData.globalsHistograms[globalIndex].entries.emplace_back();
+
+			sketch.heap.push_back(entryIndex);
+			sketch.heapIndex.push_back(entryIndex);
+			sketch.errors.push_back(0ull);
+			sketch.names.emplace_back(name? *name : fastl::string());
+			Utils::SketchSiftUp(sketch, global, entryIndex);
+			return entryIndex;
+		}
+
+		//replace the lightest entry
+		const U32 entryIndex = sketch.heap[0];
+		CompileData& compileData = global[entryIndex];
+		const U64 minAccumulated = compileData.accumulated;
+
+		dictionary.erase(compileData.nameHash);
+		dictionary.insert(TIndexDataDictionary::value_type(element.nameHash, entryIndex));
+
+		compileData = CompileData(element.nameHash);
+		compileData.accumulated = minAccumulated;
+		scoreData.globalsUnitMarks[globalIndex][entryIndex] = 0u;
+		Utils::ResetHistogram(scoreData.globalsHistograms[globalIndex], entryIndex);
+		if (entryIndex < scoreData.globalsUnitSquares[globalIndex].size())
+		{ 
+			scoreData.globalsUnitSquares[globalIndex][entryIndex] = 0.0;
+		}
+		sketch.errors[entryIndex] = minAccumulated;
+		sketch.names[entryIndex] = name? *name : fastl::string();
+
+		return entryIndex;
+	}
+
 	// -----------------------------------------------------------------------------------------------------------
 	CompileCategory GetDetailCategory(const ExportParams::Detail detail)
 	{ 
@@ -193,12 +721,53 @@ namespace CompileScore
 	}
 
 	// -----------------------------------------------------------------------------------------------------------
-	void ProcessParent( ScoreData& scoreData, CompileEvent& child, const CompileEvent* parent, const CompileUnit& unit, const ExportParams::Includers includersMode )
-	{
-		//only includes for now	
-		if( parent == nullptr || child.category != CompileCategory::Include || includersMode != ExportParams::Includers::Enabled )
-		{
-			return;
+	EventFilter::EventFilter()
+	{ 
+		ExportParams* exportParams = Context::Get<ExportParams>(); 
+		gatherLimit = exportParams? GetDetailCategory(exportParams->detail) : CompileCategory::GatherFull;
+		timelineEnabled = Context::Get<IO::ScoreBinarizer>() && exportParams && exportParams->timeline == ExportParams::Timeline::Enabled;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool EventFilter::KeepEvent(const CompileCategory category) const
+	{ 
+		//The unit totals need all displayed categories, the passes and other tags are only aggregated with the full detail
+		return category < CompileCategory::DisplayCount || timelineEnabled || (gatherLimit == CompileCategory::GatherFull && category < CompileCategory::Invalid);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool EventFilter::KeepName(const CompileCategory category) const
+	{ 
+		//Names are only referenced by the gathered globals, the aggregated passes and other tags and by the timeline 'other' tags
+		return category < gatherLimit || (category == CompileCategory::Other && timelineEnabled) || (gatherLimit == CompileCategory::GatherFull && category >= CompileCategory::DisplayCount && category < CompileCategory::Invalid);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	template<ExportParams::Includers IncludersMode>
+	void ProcessParent( ScoreData& scoreData, CompileEvent& child, const CompileEvent* parent, const CompileUnit& unit )
+	{
+		//only includes for now	
+		if constexpr ( IncludersMode != ExportParams::Includers::Enabled )
+		{
+			return;
+		}
+
+		if( child.category != CompileCategory::Include )
+		{
+			return;
+		} 
+
+		//Store the edge in the unit include graph, includes without an includer hang from the unit
+		CompileIncludeGraph& graph = scoreData.includeGraph;
+		const U32 unitEpoch = Utils::GetUnitEpoch(unit);
+		const U32 childNode = Utils::GetIncludeNode(graph, child.nameId, unitEpoch);
+		const U32 parentNode = parent && parent->category == CompileCategory::Include ? Utils::GetIncludeNode(graph, parent->nameId, unitEpoch) : 0u;
+		graph.nodeCosts[childNode] += child.selfDuration;
+		graph.edges.push_back((static_cast<U64>(parentNode) << 32u) | childNode);
+
+		if( parent == nullptr )
+		{
+			return;
 		} 
 		
 		//Store this include relationship data
@@ -219,42 +788,81 @@ namespace CompileScore
 		}
 	}
 
-	void PopTimelineStackEvent(ScoreData& scoreData, const CompileUnit& unit, fastl::vector<CompileEvent*>& eventStack, fastl::vector<U32>& dataIdStack, const CompileCategory gatherLimit, const ExportParams::Includers includersMode)
+	// -----------------------------------------------------------------------------------------------------------
+	template<CompileCategory GatherLimit, ExportParams::Includers IncludersMode, ExportParams::Globals GlobalsMode>
+	void PopTimelineStackEvent(ScoreData& scoreData, const CompileUnit& unit, Utils::TEventStack& eventStack, Utils::TDataIdStack& dataIdStack)
 	{
 		//Check what happened with the children and fixup any remaining parent data
 		CompileEvent* thisEvent = eventStack.back();
 		const U32 thisIndex = dataIdStack.back();
-		if (thisIndex != Utils::kInvalidIndex && thisEvent->category < gatherLimit)
+		if (thisIndex != Utils::kInvalidIndex && thisEvent->category < GatherLimit)
 		{
 			// Finalize post computation when closing this event ( self duration calculations )
 			TCompileDatas& global = scoreData.globals[ToUnderlying(thisEvent->category)];
 			CompileData& thisCompileData = global[thisIndex];
 
-			if (thisEvent->selfDuration >= thisCompileData.selfMaximum)
+			//in heavy hitters mode the entry might have been replaced by one of the children
+			if (GlobalsMode == ExportParams::Globals::Exact || thisCompileData.nameHash == thisEvent->nameHash)
 			{
-				thisCompileData.selfMaximum = thisEvent->selfDuration;
-				thisCompileData.selfMaxId = unit.unitId;
+				if (thisEvent->selfDuration >= thisCompileData.selfMaximum)
+				{
+					thisCompileData.selfMaximum = thisEvent->selfDuration;
+					thisCompileData.selfMaxId = unit.unitId;
+				}
+
+				thisCompileData.selfAccumulated += thisEvent->selfDuration;
 			}
+		}
 
-			thisCompileData.selfAccumulated += thisEvent->selfDuration;
+		if constexpr (GatherLimit == CompileCategory::GatherFull)
+		{ 
+			if (thisEvent->category == CompileCategory::Other)
+			{ 
+				Utils::AccumulateEventData(scoreData.otherDatas[thisEvent->nameId], scoreData.otherDatasUnitMarks[thisEvent->nameId], *thisEvent, unit);
+			}
+			else if (Utils::IsPassCategory(thisEvent->category))
+			{ 
+				const U32 passIndex = CreatePassEntry(scoreData, *thisEvent);
+				Utils::AccumulateEventData(scoreData.passes[passIndex], scoreData.passesUnitMarks[passIndex], *thisEvent, unit);
+			}
 		}
 
 		eventStack.pop_back();
 		dataIdStack.pop_back();
 
+		//the pass managers run the passes, their self time excludes any nested pass
 		CompileEvent* parent = eventStack.empty() ? nullptr : eventStack.back();
-		if (parent != nullptr && thisEvent->category == parent->category) {
+		if (parent != nullptr && (thisEvent->category == parent->category || (Utils::IsPassCategory(thisEvent->category) && Utils::IsPassCategory(parent->category))))
+		{ 
 			parent->selfDuration -= thisEvent->duration;
 		}
 
-		ProcessParent(scoreData, *thisEvent, parent, unit, includersMode);
+		//the parent relationships are only tracked for gathered entries
+		if (thisIndex != Utils::kInvalidIndex)
+		{ 
+			ProcessParent<IncludersMode>(scoreData, *thisEvent, parent, unit);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	fastl::Arena& GetScratchArena()
+	{ 
+		//each worker thread gets its own scratch memory
+		thread_local fastl::Arena arena;
+		return arena;
 	}
 
 	// -----------------------------------------------------------------------------------------------------------
-	void ProcessTimelineTrack(ScoreData& scoreData, CompileUnit& unit, TCompileEvents& events, TUniqueElementsSet& uniqueElements, const CompileCategory gatherLimit, const ExportParams::Includers includersMode )
+	// Timeline processing kernel, the export configuration is baked in so the event loop has no configuration checks
+	template<CompileCategory GatherLimit, ExportParams::Includers IncludersMode, ExportParams::Globals GlobalsMode>
+	void ProcessTimelineTrack(ScoreData& scoreData, CompileUnit& unit, TCompileEvents& events)
 	{ 
-		fastl::vector<CompileEvent*> eventStack;
-		fastl::vector<U32>           dataIdStack;
+		const U32 unitEpoch = Utils::GetUnitEpoch(unit);
+
+		fastl::Arena& arena = GetScratchArena();
+		fastl::ArenaScope scratchScope(arena);
+		Utils::TEventStack  eventStack(&arena);
+		Utils::TDataIdStack dataIdStack(&arena);
 
 		//Process Timeline elements
 		for (CompileEvent& element : events)
@@ -262,18 +870,26 @@ namespace CompileScore
 			//update stack 
 			while (!eventStack.empty() && (element.start >= eventStack.back()->start + eventStack.back()->duration))
 			{
-				PopTimelineStackEvent(scoreData, unit, eventStack, dataIdStack, gatherLimit, includersMode);
+				PopTimelineStackEvent<GatherLimit,IncludersMode,GlobalsMode>(scoreData, unit, eventStack, dataIdStack);
 			}
 			CompileEvent* parent = eventStack.empty() ? nullptr : eventStack.back();
 			eventStack.push_back( &element );
 
-			if (element.category < gatherLimit)
+			if (element.category < GatherLimit)
 			{ 
-				const U32 globalIndex = CreateGlobalEntry(scoreData,element);
-				CompileData& compileData = scoreData.globals[ToUnderlying(element.category)][globalIndex];
+				const bool isSketched = GlobalsMode == ExportParams::Globals::HeavyHitters && Utils::IsSketchCategory(element.category);
+				const U32 globalIndex = isSketched? CreateSketchEntry(scoreData,element) : CreateGlobalEntry(scoreData,element);
+				TCompileDatas& global = scoreData.globals[ToUnderlying(element.category)];
+				CompileData& compileData = global[globalIndex];
 				dataIdStack.push_back(globalIndex);
 
 				compileData.accumulated += element.duration;
+
+				if (isSketched)
+				{ 
+					CompileDataSketch& sketch = scoreData.globalsSketch[ToUnderlying(element.category)];
+					Utils::SketchSiftDown(sketch, global, sketch.heapIndex[globalIndex]);
+				}
 				compileData.minimum = Utils::Min(element.duration,compileData.minimum);
 
 				if (element.duration >= compileData.maximum)
@@ -283,10 +899,13 @@ namespace CompileScore
 				}
 
 				++compileData.count;
+				Utils::AddHistogramSample(scoreData.globalsHistograms[ToUnderlying(element.category)], globalIndex, Utils::GetHistogramBucket(element.duration));
 
-				const auto insertionResult = uniqueElements.emplace(Utils::GetUniqueElementHash(element.category, globalIndex));
-				if (insertionResult.second)
+				//first time this entry is seen in this unit
+				U32& unitMark = scoreData.globalsUnitMarks[ToUnderlying(element.category)][globalIndex];
+				if (unitMark != unitEpoch)
 				{
+					unitMark = unitEpoch;
 					++compileData.unitCount;
 					++compileData.unitAccumulated += unit.values[ToUnderlying(CompileCategory::ExecuteCompiler)];
 				}
@@ -313,17 +932,250 @@ namespace CompileScore
 		//Pop the remaining stack
 		while (!eventStack.empty())
 		{
-			PopTimelineStackEvent(scoreData, unit, eventStack, dataIdStack, gatherLimit, includersMode);
+			PopTimelineStackEvent<GatherLimit,IncludersMode,GlobalsMode>(scoreData, unit, eventStack, dataIdStack);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	using TTimelineTrackKernel = void(*)(ScoreData& scoreData, CompileUnit& unit, TCompileEvents& events);
+
+	// -----------------------------------------------------------------------------------------------------------
+	template<CompileCategory GatherLimit, ExportParams::Includers IncludersMode>
+	TTimelineTrackKernel GetTimelineTrackKernel(const ExportParams::Globals globalsMode)
+	{ 
+		return globalsMode == ExportParams::Globals::HeavyHitters? 
+			&ProcessTimelineTrack<GatherLimit, IncludersMode, ExportParams::Globals::HeavyHitters> : 
+			&ProcessTimelineTrack<GatherLimit, IncludersMode, ExportParams::Globals::Exact>;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	template<CompileCategory GatherLimit>
+	TTimelineTrackKernel GetTimelineTrackKernel(const ExportParams::Includers includersMode, const ExportParams::Globals globalsMode)
+	{ 
+		return includersMode == ExportParams::Includers::Enabled? 
+			GetTimelineTrackKernel<GatherLimit, ExportParams::Includers::Enabled>(globalsMode) : 
+			GetTimelineTrackKernel<GatherLimit, ExportParams::Includers::Disabled>(globalsMode);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	TTimelineTrackKernel GetTimelineTrackKernel(const CompileCategory gatherLimit, const ExportParams::Includers includersMode, const ExportParams::Globals globalsMode)
+	{ 
+		switch(gatherLimit)
+		{ 
+			case CompileCategory::GatherNone:     return GetTimelineTrackKernel<CompileCategory::GatherNone>(includersMode, globalsMode);
+			case CompileCategory::GatherBasic:    return GetTimelineTrackKernel<CompileCategory::GatherBasic>(includersMode, globalsMode);
+			case CompileCategory::GatherFrontEnd: return GetTimelineTrackKernel<CompileCategory::GatherFrontEnd>(includersMode, globalsMode);
+			default:                              return GetTimelineTrackKernel<CompileCategory::GatherFull>(includersMode, globalsMode);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Dominator tree of the unit include graph ( Cooper, Harvey, Kennedy iterative algorithm ), the cost of every include 
+	// dominated by a node would disappear with it as there is no other path from the unit to them
+	void ComputeExclusiveIncludeCosts(ScoreData& scoreData)
+	{ 
+		const CompileIncludeGraph& graph = scoreData.includeGraph;
+		const U32 numNodes = static_cast<U32>(graph.nodeIncludeIds.size());
+		const U32 numEdges = static_cast<U32>(graph.edges.size());
+		if (numNodes <= 1u)
+		{ 
+			return;
+		}
+
+		fastl::Arena& arena = GetScratchArena();
+		fastl::ArenaScope scratchScope(arena);
+		using TScratchIds = fastl::vector<U32, fastl::ArenaAllocator<U32>>;
+		using TScratchCosts = fastl::vector<U64, fastl::ArenaAllocator<U64>>;
+
+		//successors and predecessors in compressed rows
+		TScratchIds successorOffsets(&arena);
+		TScratchIds successors(&arena);
+		TScratchIds predecessorOffsets(&arena);
+		TScratchIds predecessors(&arena);
+		successorOffsets.resize(numNodes + 1u);
+		predecessorOffsets.resize(numNodes + 1u);
+		successors.resize(numEdges);
+		predecessors.resize(numEdges);
+
+		for (const U64 edge : graph.edges)
+		{ 
+			++successorOffsets[static_cast<U32>(edge >> 32u) + 1u];
+			++predecessorOffsets[static_cast<U32>(edge) + 1u];
+		}
+		for (U32 i = 0u; i < numNodes; ++i)
+		{ 
+			successorOffsets[i + 1u] += successorOffsets[i];
+			predecessorOffsets[i + 1u] += predecessorOffsets[i];
+		}
+		{ 
+			TScratchIds successorCursor(successorOffsets);
+			TScratchIds predecessorCursor(predecessorOffsets);
+			for (const U64 edge : graph.edges)
+			{ 
+				const U32 from = static_cast<U32>(edge >> 32u);
+				const U32 to = static_cast<U32>(edge);
+				successors[successorCursor[from]++] = to;
+				predecessors[predecessorCursor[to]++] = from;
+			}
+		}
+
+		//iterative depth first post order from the unit
+		TScratchIds postOrder(&arena);
+		TScratchIds postIndex(&arena);
+		TScratchIds visitCursor(&arena);
+		TScratchIds stack(&arena);
+		postOrder.reserve(numNodes);
+		postIndex.resize(numNodes);
+		visitCursor.resize(numNodes);
+		for (U32 i = 0u; i < numNodes; ++i)
+		{ 
+			postIndex[i] = InvalidCompileId;
+			visitCursor[i] = successorOffsets[i];
+		}
+
+		stack.push_back(0u);
+		postIndex[0] = 0u; //visited mark, overwritten once finished
+		while (!stack.empty())
+		{ 
+			const U32 node = stack.back();
+			if (visitCursor[node] < successorOffsets[node + 1u])
+			{ 
+				const U32 next = successors[visitCursor[node]++];
+				if (postIndex[next] == InvalidCompileId)
+				{ 
+					postIndex[next] = 0u;
+					stack.push_back(next);
+				}
+			}
+			else
+			{ 
+				postIndex[node] = static_cast<U32>(postOrder.size());
+				postOrder.push_back(node);
+				stack.pop_back();
+			}
+		}
+
+		//immediate dominators, iterated in reverse post order until stable
+		TScratchIds idom(&arena);
+		idom.resize(numNodes);
+		for (U32 i = 0u; i < numNodes; ++i)
+		{ 
+			idom[i] = InvalidCompileId;
+		}
+		idom[0] = 0u;
+
+		auto intersect = [&](U32 a, U32 b)
+		{ 
+			while (a != b)
+			{ 
+				while (postIndex[a] < postIndex[b]) a = idom[a];
+				while (postIndex[b] < postIndex[a]) b = idom[b];
+			}
+			return a;
+		};
+
+		const U32 numReached = static_cast<U32>(postOrder.size());
+		for (bool changed = true; changed;)
+		{ 
+			changed = false;
+			for (U32 i = numReached - 1u; i > 0u; --i)
+			{ 
+				const U32 node = postOrder[i - 1u];
+				U32 newIdom = InvalidCompileId;
+				for (U32 k = predecessorOffsets[node], end = predecessorOffsets[node + 1u]; k < end; ++k)
+				{ 
+					const U32 predecessor = predecessors[k];
+					if (idom[predecessor] != InvalidCompileId)
+					{ 
+						newIdom = newIdom == InvalidCompileId ? predecessor : intersect(predecessor, newIdom);
+					}
+				}
+
+				if (idom[node] != newIdom)
+				{ 
+					idom[node] = newIdom;
+					changed = true;
+				}
+			}
+		}
+
+		//post order visits the dominated nodes before their dominator
+		TScratchCosts exclusive(&arena);
+		exclusive.resize(numNodes);
+		for (U32 i = 0u; i < numReached; ++i)
+		{ 
+			const U32 node = postOrder[i];
+			if (node == 0u) continue;
+
+			exclusive[node] += graph.nodeCosts[node];
+			exclusive[idom[node]] += exclusive[node];
+			scoreData.includeCosts[graph.nodeIncludeIds[node]].exclusive += exclusive[node];
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// The spread of the per unit contributions of each entry gives the confidence interval for the sampled extrapolation
+	void GatherSampleSums(ScoreData& scoreData, const ScoreTimeline& timeline, const CompileCategory gatherLimit)
+	{ 
+		fastl::Arena& arena = GetScratchArena();
+		fastl::ArenaScope scratchScope(arena);
+		fastl::vector<U64, fastl::ArenaAllocator<U64>> touched(&arena); //category and entry of each entry visited by this unit
+
+		for (CompileCategoryType i = 0; i < ToUnderlying(gatherLimit); ++i)
+		{ 
+			scoreData.globalsUnitSums[i].resize(scoreData.globals[i].size());
+			scoreData.globalsUnitSquares[i].resize(scoreData.globals[i].size());
+		}
+
+		for (const TCompileEvents& track : timeline.tracks)
+		{ 
+			for (const CompileEvent& element : track)
+			{ 
+				if (element.category >= gatherLimit)
+				{ 
+					continue;
+				}
+
+				//look up by name, heavy hitters entries don't keep their ids and might have been replaced
+				const CompileCategoryType globalIndex = ToUnderlying(element.category);
+				TIndexDataDictionary::const_iterator found = scoreData.globalsDictionary[globalIndex].find(element.nameHash);
+				if (found == scoreData.globalsDictionary[globalIndex].end())
+				{ 
+					continue;
+				}
+
+				U64& unitSum = scoreData.globalsUnitSums[globalIndex][found->second];
+				if (unitSum == 0u)
+				{ 
+					touched.push_back((static_cast<U64>(globalIndex) << 32u) | found->second);
+				}
+				unitSum += element.duration;
+			}
+		}
+
+		for (const U64 entry : touched)
+		{ 
+			const CompileCategoryType globalIndex = static_cast<CompileCategoryType>(entry >> 32u);
+			const U32 entryIndex = static_cast<U32>(entry);
+			U64& unitSum = scoreData.globalsUnitSums[globalIndex][entryIndex];
+			const double contribution = static_cast<double>(unitSum);
+			scoreData.globalsUnitSquares[globalIndex][entryIndex] += contribution * contribution;
+			unitSum = 0u;
 		}
 	}
 
 	// -----------------------------------------------------------------------------------------------------------
 	void ProcessTimeline(ScoreData& scoreData, ScoreTimeline& timeline, const CompileUnitContext& context)
 	{
-		//Get Gather limit
+		PROFILE_ZONE("Process Events");
+
+		//Pick the processing kernel for the current export configuration
 		ExportParams* exportParams = Context::Get<ExportParams>(); 
 		const CompileCategory gatherLimit = exportParams? GetDetailCategory(exportParams->detail) : CompileCategory::GatherFull;
-		ExportParams::Includers includersMode = exportParams ? exportParams->includers : ExportParams::Includers::Enabled;
+		const ExportParams::Includers includersMode = exportParams ? exportParams->includers : ExportParams::Includers::Enabled;
+		const ExportParams::Globals globalsMode = exportParams ? exportParams->globals : ExportParams::Globals::Exact;
+		const TTimelineTrackKernel processTrack = GetTimelineTrackKernel(gatherLimit, includersMode, globalsMode);
+		scoreData.globalsCapacity = globalsMode == ExportParams::Globals::HeavyHitters? exportParams->globalsCapacity : 0u;
 
 		//Create new unit
 		const U32 unitId = static_cast<U32>(scoreData.units.size());
@@ -331,12 +1183,36 @@ namespace CompileScore
 		CompileUnit& unit = scoreData.units.back();
 		unit.nameHash = timeline.nameHash;
 		unit.context = context;
-		
-		TUniqueElementsSet uniqueElements;
+
+		Utils::ResetIncludeGraph(scoreData.includeGraph);
 
 		for (TCompileEvents& track : timeline.tracks)
 		{ 
-			ProcessTimelineTrack(scoreData, unit, track, uniqueElements, gatherLimit, includersMode);
+			processTrack(scoreData, unit, track);
+		}
+
+		if (includersMode == ExportParams::Includers::Enabled)
+		{ 
+			ComputeExclusiveIncludeCosts(scoreData);
+
+			//every include in the graph is included by this unit transitively
+			const CompileIncludeGraph& graph = scoreData.includeGraph;
+			for (size_t i = 1u, sz = graph.nodeIncludeIds.size(); i < sz; ++i)
+			{ 
+				Utils::AddToUnitSet(scoreData.includeCosts[graph.nodeIncludeIds[i]].units, unitId);
+			}
+		}
+
+		//the names of the untracked symbols are no longer needed, the demangled ones point into them
+		scoreData.transientStrings.clear();
+		if (globalsMode == ExportParams::Globals::HeavyHitters)
+		{ 
+			scoreData.demangledNames.clear();
+		}
+
+		if (exportParams && exportParams->samplePercent < 100u)
+		{ 
+			GatherSampleSums(scoreData, timeline, gatherLimit);
 		}
 
 		IO::ScoreBinarizer* binarizer = Context::Get<IO::ScoreBinarizer>(); 
@@ -362,19 +1238,20 @@ namespace CompileScore
 	}
 
 	// -----------------------------------------------------------------------------------------------------------
-	size_t AddFolder(TCompileFolders& folders, const char* path)
+	size_t AddFolder(TCompileFolders& folders, const Utils::FolderPath& folderPath)
 	{
 		//Find and create the current folder node
 		size_t folderIndex = 0;
-		const char* folderStart = path;
-		const char* folderEnd = path;
+		size_t folderNumber = 0;
+		const char* folderStart = folderPath.path;
+		const char* folderEnd = folderPath.path;
 		for (; *folderEnd != '\0'; ++folderEnd)
 		{
 			if (*folderEnd == '/' || *folderEnd == '\\')
 			{
 				//folder found, move or create
 				const size_t folderNameLength = folderEnd - folderStart;
-				const U64 strHash = Hash::AppendToCRC64(0ull, folderStart, folderNameLength);
+				const U64 strHash = folderPath.folderHashes[folderNumber++];
 
 				CompileFolder& currentFolder = folders[folderIndex];
 
@@ -393,20 +1270,378 @@ namespace CompileScore
 		return folderIndex;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------
+	void AccumulateScope(CompileScope& scope, const size_t category, const CompileData& data)
+	{
+		scope.accumulated[category] += data.accumulated;
+		scope.selfAccumulated[category] += data.selfAccumulated;
+		scope.count[category] += data.count;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Namespace and class roll up of the symbol globals, each scope accumulates all the symbols found inside it
+	void ComputeScopes(ScoreData& scoreData)
+	{
+		PROFILE_ZONE("ComputeScopes");
+
+		constexpr size_t firstCategory = ToUnderlying(CompileCategory::Include) + 1u;
+		constexpr size_t lastCategory = ToUnderlying(CompileCategory::GatherFull);
+
+		TCompileScopes& scopes = scoreData.scopes;
+		scopes.clear();
+		scopes.emplace_back();
+
+		size_t offsets[lastCategory + 1u] = {};
+		for (size_t category = firstCategory; category < lastCategory; ++category)
+		{
+			offsets[category + 1u] = offsets[category] + scoreData.globals[category].size();
+		}
+
+		//Resolve all names upfront, the scope tree needs to be built in order to keep the scope ids stable
+		fastl::vector<Utils::ScopePath> scopePaths(offsets[lastCategory]);
+		auto resolveScopePath = [&](const size_t index)
+		{
+			size_t category = firstCategory;
+			while (index >= offsets[category + 1u]) ++category;
+			Utils::ResolveScopePath(scopePaths[index], scoreData.strings, scoreData.globals[category][index - offsets[category]].nameHash);
+		};
+		Threading::ParallelFor("Resolve Scopes", scopePaths.size(), resolveScopePath);
+
+		for (size_t category = firstCategory; category < lastCategory; ++category)
+		{
+			const TCompileDatas& globals = scoreData.globals[category];
+			for (size_t i = 0u, sz = globals.size(); i < sz; ++i)
+			{
+				const Utils::ScopePath& scopePath = scopePaths[offsets[category] + i];
+				if (scopePath.name == nullptr) continue;
+
+				size_t scopeIndex = 0u;
+				AccumulateScope(scopes[scopeIndex], category, globals[i]);
+
+				for (const Utils::ScopePath::Scope& scope : scopePath.scopes)
+				{
+					//Scope found, move or create
+					auto const& result = scopes[scopeIndex].children.insert(TIndexDataDictionary::value_type(scope.hash, static_cast<U32>(scopes.size())));
+					scopeIndex = result.first->second;
+					if (result.second)
+					{
+						scopes.emplace_back(scopePath.name + scope.start, scope.length);
+					}
+
+					AccumulateScope(scopes[scopeIndex], category, globals[i]);
+				}
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// What a one line change in each include costs: the compilation time of every unit including it transitively
+	void ComputeRebuildCosts(ScoreData& scoreData)
+	{ 
+		const TCompileUnits& units = scoreData.units;
+		const U32 numUnits = static_cast<U32>(units.size());
+
+		//prefix sums over the unit ids, each full word run costs a single subtraction
+		fastl::vector<U64> unitsPrefix(numUnits + 1u);
+		for (U32 unitId = 0u; unitId < numUnits; ++unitId)
+		{ 
+			unitsPrefix[unitId + 1u] = unitsPrefix[unitId] + units[unitId].values[ToUnderlying(CompileCategory::ExecuteCompiler)];
+		}
+
+		auto computeRebuildCost = [&](const size_t index)
+		{ 
+			CompileIncludeCost& includeCost = scoreData.includeCosts[index];
+			includeCost.rebuildCost = 0u;
+			includeCost.rebuildUnits = 0u;
+
+			for (const CompileUnitSet::Chunk& chunk : includeCost.units.chunks)
+			{ 
+				const U32 runStart = Utils::Min(chunk.firstWord << 6u, numUnits);
+				const U32 runEnd = Utils::Min((chunk.firstWord + chunk.fullWords) << 6u, numUnits);
+				includeCost.rebuildCost += unitsPrefix[runEnd] - unitsPrefix[runStart];
+				includeCost.rebuildUnits += chunk.fullWords << 6u;
+
+				const U32 literalBase = (chunk.firstWord + chunk.fullWords) << 6u;
+				for (U64 literal = chunk.literal; literal; literal &= literal - 1u)
+				{ 
+					const U32 unitId = literalBase + Utils::CountTrailingZeros(literal);
+					includeCost.rebuildCost += units[unitId].values[ToUnderlying(CompileCategory::ExecuteCompiler)];
+				}
+				includeCost.rebuildUnits += Utils::PopCount(chunk.literal);
+			}
+		};
+		Threading::ParallelFor("Rebuild Costs", scoreData.includeCosts.size(), computeRebuildCost);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	void ComputeQuantiles(ScoreData& scoreData)
+	{ 
+		for (size_t i = 0; i < ToUnderlying(CompileCategory::GatherFull); ++i)
+		{ 
+			TCompileDatas& global = scoreData.globals[i];
+			const CompileHistograms& histograms = scoreData.globalsHistograms[i];
+
+			auto computeQuantiles = [&](const size_t index)
+			{ 
+				CompileData& compileData = global[index];
+				U32 buckets[CompileHistogram::NUM_BUCKETS];
+				Utils::GetHistogramBuckets(histograms, static_cast<U32>(index), buckets);
+
+				//count the histogram itself, the entry count might not match it ( heavy hitters replacements )
+				U64 totalCount = 0u;
+				for (const U32 bucketCount : buckets)
+				{ 
+					totalCount += bucketCount;
+				}
+
+				if (totalCount > 0u)
+				{ 
+					compileData.p50 = Utils::GetHistogramQuantile(buckets, compileData, totalCount, 0.50);
+					compileData.p90 = Utils::GetHistogramQuantile(buckets, compileData, totalCount, 0.90);
+					compileData.p99 = Utils::GetHistogramQuantile(buckets, compileData, totalCount, 0.99);
+				}
+			};
+			Threading::ParallelFor("Quantiles", global.size(), computeQuantiles);
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Scales the sampled values up to the full population, the margins are the 95% confidence interval of the estimated totals
+	void ExtrapolateSample(ScoreData& scoreData)
+	{ 
+		CompileSession& session = scoreData.session;
+		fastl::memset(session.totalsMargin, 0, sizeof(U64) * ToUnderlying(CompileCategory::DisplayCount));
+
+		const double sampleUnits = static_cast<double>(scoreData.units.size());
+		if (session.sampledFiles == 0u || scoreData.units.empty())
+		{ 
+			return;
+		}
+
+		const double scale = static_cast<double>(session.totalFiles) / static_cast<double>(session.sampledFiles);
+		const double populationUnits = sampleUnits * scale;
+		const double finiteCorrection = 1.0 - 1.0 / scale;
+
+		auto computeMargin = [=](const double sum, const double squares) -> U64
+		{ 
+			if (sampleUnits < 2.0) return 0u;
+			const double variance = (squares - sum * sum / sampleUnits) / (sampleUnits - 1.0);
+			return variance > 0.0 ? static_cast<U64>(1.96 * populationUnits * sqrt(variance / sampleUnits * finiteCorrection) + 0.5) : 0u;
+		};
+
+		auto extrapolate = [=](const U64 value) -> U64 { return static_cast<U64>(static_cast<double>(value) * scale + 0.5); };
+
+		for (size_t i = 0; i < ToUnderlying(CompileCategory::DisplayCount); ++i)
+		{ 
+			double squares = 0.0;
+			for (const CompileUnit& unit : scoreData.units)
+			{ 
+				const double value = static_cast<double>(unit.values[i]);
+				squares += value * value;
+			}
+
+			session.totalsMargin[i] = computeMargin(static_cast<double>(session.totals[i]), squares);
+			session.totals[i] = extrapolate(session.totals[i]);
+		}
+
+		for (size_t i = 0; i < ToUnderlying(CompileCategory::GatherFull); ++i)
+		{ 
+			TCompileDatas& global = scoreData.globals[i];
+			TSampleMargins& margins = scoreData.globalsMargin[i];
+			const TSampleSquares& squares = scoreData.globalsUnitSquares[i];
+			margins.resize(global.size());
+
+			for (size_t k = 0; k < global.size(); ++k)
+			{ 
+				CompileData& compileData = global[k];
+
+				//the heavy hitters carry over is already bounded by the entry error, the squares only cover its own samples
+				const U64 carryOver = k < scoreData.globalsSketch[i].errors.size()? scoreData.globalsSketch[i].errors[k] : 0u;
+				margins[k] = k < squares.size() ? computeMargin(static_cast<double>(compileData.accumulated - carryOver), squares[k]) : 0u;
+
+				compileData.accumulated     = extrapolate(compileData.accumulated);
+				compileData.selfAccumulated = extrapolate(compileData.selfAccumulated);
+				compileData.unitAccumulated = extrapolate(compileData.unitAccumulated);
+				compileData.count           = static_cast<U32>(extrapolate(compileData.count));
+				compileData.unitCount       = static_cast<U32>(extrapolate(compileData.unitCount));
+			}
+
+			for (U64& error : scoreData.globalsSketch[i].errors)
+			{ 
+				error = extrapolate(error);
+			}
+		}
+
+		auto extrapolateEvents = [=](TCompileDatas& events)
+		{ 
+			for (CompileData& compileData : events)
+			{ 
+				compileData.accumulated     = extrapolate(compileData.accumulated);
+				compileData.selfAccumulated = extrapolate(compileData.selfAccumulated);
+				compileData.unitAccumulated = extrapolate(compileData.unitAccumulated);
+				compileData.count           = static_cast<U32>(extrapolate(compileData.count));
+				compileData.unitCount       = static_cast<U32>(extrapolate(compileData.unitCount));
+			}
+		};
+
+		extrapolateEvents(scoreData.passes);
+		extrapolateEvents(scoreData.otherDatas);
+
+		//the includer unit entries are real units, only the edges between includes are population estimates
+		for (CompileIncluder& includer : scoreData.includers)
+		{ 
+			for (auto& include : includer.includes)
+			{ 
+				include.second.accumulated = extrapolate(include.second.accumulated);
+				include.second.count       = static_cast<U32>(extrapolate(include.second.count));
+			}
+		}
+
+		for (CompileScope& scope : scoreData.scopes)
+		{ 
+			for (size_t i = 0; i < ToUnderlying(CompileCategory::GatherFull); ++i)
+			{ 
+				scope.accumulated[i]     = extrapolate(scope.accumulated[i]);
+				scope.selfAccumulated[i] = extrapolate(scope.selfAccumulated[i]);
+				scope.count[i]           = static_cast<U32>(extrapolate(scope.count[i]));
+			}
+		}
+
+		for (CompileIncludeCost& includeCost : scoreData.includeCosts)
+		{ 
+			includeCost.exclusive = extrapolate(includeCost.exclusive);
+			includeCost.rebuildCost = extrapolate(includeCost.rebuildCost);
+			includeCost.rebuildUnits = static_cast<U32>(extrapolate(includeCost.rebuildUnits));
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	// Sweep line over the unit start and finish times, needs the normalized start times and the session full duration
+	void ComputeConcurrency(ScoreData& scoreData)
+	{ 
+		CompileConcurrency& concurrency = scoreData.concurrency;
+		concurrency = CompileConcurrency();
+
+		const U64 fullDuration = scoreData.session.fullDuration;
+		if (scoreData.units.empty() || fullDuration == 0u)
+		{ 
+			return;
+		}
+
+		//time in the high bits and start/finish in the lowest one, finishes go first when both happen at the same time
+		fastl::vector<U64> events;
+		fastl::vector<U64> unitFinish(scoreData.units.size());
+		events.reserve(scoreData.units.size() * 2u);
+		for (const CompileUnit& unit : scoreData.units)
+		{ 
+			const U64 start = Utils::Min(unit.context.startTime[0], unit.context.startTime[1]);
+			const U64 finish = Utils::Max(unit.context.startTime[0] + unit.values[ToUnderlying(CompileCategory::FrontEnd)], 
+			                              unit.context.startTime[1] + unit.values[ToUnderlying(CompileCategory::BackEnd)]);
+			unitFinish[unit.unitId] = finish;
+			events.push_back(start << 1u | 1u);
+			events.push_back(finish << 1u);
+		}
+		fastl::sort(events.begin(), events.end());
+
+		concurrency.sliceDuration = (fullDuration + CompileConcurrency::NUM_SLICES - 1u) / CompileConcurrency::NUM_SLICES;
+		concurrency.sliceActivity.resize(CompileConcurrency::NUM_SLICES);
+
+		auto addSegment = [&](const U64 from, const U64 to, const U32 active)
+		{ 
+			if (to <= from) return;
+
+			if (concurrency.levelDurations.size() <= active)
+			{ 
+				concurrency.levelDurations.resize(active + 1u);
+			}
+			concurrency.levelDurations[active] += to - from;
+
+			for (U64 time = from; time < to && active > 0u; )
+			{ 
+				const U64 slice = Utils::Min<U64>(time / concurrency.sliceDuration, CompileConcurrency::NUM_SLICES - 1u);
+				const U64 sliceEnd = Utils::Min((slice + 1u) * concurrency.sliceDuration, to);
+				concurrency.sliceActivity[slice] += (sliceEnd - time) * active;
+				time = sliceEnd;
+			}
+		};
+
+		U64 lastTime = 0u;
+		U32 active = 0u;
+		for (const U64 event : events)
+		{ 
+			const U64 time = event >> 1u;
+			addSegment(lastTime, time, active);
+			lastTime = time;
+			active = (event & 1u) ? active + 1u : active - 1u;
+			concurrency.peak = Utils::Max(concurrency.peak, active);
+		}
+		addSegment(lastTime, fullDuration, active);
+
+		//the tail starts when the concurrency drops under half the peak for the last time
+		const U32 tailThreshold = (concurrency.peak + 1u) / 2u;
+		active = 0u;
+		for (const U64 event : events)
+		{ 
+			const U32 previous = active;
+			active = (event & 1u) ? active + 1u : active - 1u;
+			if (previous >= tailThreshold && active < tailThreshold)
+			{ 
+				concurrency.tailStart = event >> 1u;
+			}
+		}
+
+		for (const CompileUnit& unit : scoreData.units)
+		{ 
+			if (unitFinish[unit.unitId] > concurrency.tailStart)
+			{ 
+				concurrency.tailUnitIds.push_back(unit.unitId);
+			}
+		}
+
+		fastl::sort(concurrency.tailUnitIds.begin(), concurrency.tailUnitIds.end(), 
+			[&](const U32 a, const U32 b) { return unitFinish[a] < unitFinish[b]; });
+	}
+
 	// -----------------------------------------------------------------------------------------------------------
 	void FinalizeScoreData(ScoreData& scoreData)
 	{
+		PROFILE_ZONE("Finalize");
+
+		//the tracked heavy hitters keep their names
+		for (CompileDataSketch& sketch : scoreData.globalsSketch)
+		{
+			for (fastl::string& name : sketch.names)
+			{
+				StoreString(scoreData, name);
+			}
+			sketch.names.clear();
+		}
+
 		//setup the scoredata
 		scoreData.folders.clear();
 		scoreData.folders.emplace_back();
 		scoreData.session.fullDuration = 0u; 
 		fastl::memset(scoreData.session.totals, 0, sizeof(U64) * ToUnderlying(CompileCategory::DisplayCount));
 
+		//Resolve all unit and include paths upfront, the folder tree needs to be built in order to keep the folder ids stable
+		const TCompileDatas& includeData = scoreData.globals[ToUnderlying(CompileCategory::Include)];
+		const size_t numUnits = scoreData.units.size();
+		fastl::vector<Utils::FolderPath> folderPaths(numUnits + includeData.size());
+
+		auto resolveFolderPath = [&](const size_t index)
+		{
+			const U64 nameHash = index < numUnits ? scoreData.units[index].nameHash : includeData[index - numUnits].nameHash;
+			Utils::ResolveFolderPath(folderPaths[index], scoreData.strings, nameHash);
+		};
+		Threading::ParallelFor("Resolve Folders", folderPaths.size(), resolveFolderPath);
+
 		//Normalize unit start times
 		U64 minStartTime = 0xffffffffffffffff;
 
-		for (CompileUnit& unit : scoreData.units)
+		for (size_t unitIndex = 0; unitIndex < numUnits; ++unitIndex)
 		{
+			CompileUnit& unit = scoreData.units[unitIndex];
+
 			//Add Threads and prepare for total time computations
 			for (size_t k = 0; k < 2; ++k)
 			{
@@ -420,10 +1655,10 @@ namespace CompileScore
 			}
 
 			//Add path to folders
-			TCompileStrings::const_iterator found = scoreData.strings.find(unit.nameHash);
-			if (found != scoreData.strings.end())
+			const Utils::FolderPath& folderPath = folderPaths[unitIndex];
+			if (folderPath.path)
 			{
-				const size_t folderIndex = AddFolder(scoreData.folders,found->second.c_str());
+				const size_t folderIndex = AddFolder(scoreData.folders,folderPath);
 				scoreData.folders[folderIndex].unitIds.emplace_back(unit.unitId);
 			}
 		}
@@ -438,18 +1673,63 @@ namespace CompileScore
 			scoreData.session.fullDuration = scoreData.session.fullDuration > backEndFinish ? scoreData.session.fullDuration : backEndFinish;
 		}
 
+		ComputeConcurrency(scoreData);
+		ComputeQuantiles(scoreData);
+		ComputeRebuildCosts(scoreData);
+
 		//Add folder paths for the includes
-		const TCompileDatas& includeData = scoreData.globals[ToUnderlying(CompileCategory::Include)];
 		const U32 numIncludes = static_cast<U32>(includeData.size());
 		for (U32 i=0;i<numIncludes;++i)
 		{
-			const CompileData& data = includeData[i];
-			TCompileStrings::const_iterator found = scoreData.strings.find(data.nameHash);
-			if (found != scoreData.strings.end())
+			const Utils::FolderPath& folderPath = folderPaths[numUnits + i];
+			if (folderPath.path)
 			{
-				const size_t folderIndex = AddFolder(scoreData.folders, found->second.c_str());
+				const size_t folderIndex = AddFolder(scoreData.folders, folderPath);
 				scoreData.folders[folderIndex].includeIds.emplace_back(i);
 			}
 		}
+
+		ComputeScopes(scoreData);
+
+		//Join the build system log
+		const ExportParams* exportParams = Context::Get<ExportParams>();
+		if (exportParams && exportParams->buildLog && BuildLog::ReadNinjaLog(scoreData, exportParams->buildLog))
+		{
+			BuildLog::ComputeCriticalPath(scoreData);
+
+			fastl::string reportFilename = exportParams->output;
+			reportFilename += ".critical.txt";
+			BuildLog::WriteReport(scoreData, reportFilename.c_str());
+		}
+
+		//What-if build simulation
+		if (exportParams && exportParams->simulateCores)
+		{
+			fastl::string reportFilename = exportParams->output;
+			reportFilename += ".simulate.txt";
+			Simulator::WriteReport(scoreData, exportParams->simulateCores, reportFilename.c_str());
+		}
+
+		//Precompiled header suggestions
+		if (exportParams && exportParams->pchBudget)
+		{
+			fastl::string reportFilename = exportParams->output;
+			reportFilename += ".pch.txt";
+			Suggestions::WritePCHReport(scoreData, exportParams->pchBudget, reportFilename.c_str());
+		}
+
+		//Unity build suggestions
+		if (exportParams && exportParams->unityUnits)
+		{
+			fastl::string reportFilename = exportParams->output;
+			reportFilename += ".unity.txt";
+			Suggestions::WriteUnityReport(scoreData, exportParams->unityUnits, reportFilename.c_str());
+		}
+
+		//The reports above replay the sampled units, they need the raw values
+		if (scoreData.session.IsSampled())
+		{ 
+			ExtrapolateSample(scoreData);
+		}
 	}
 }
\ No newline at end of file
@@ -4,8 +4,22 @@ struct ScoreData;
 struct ScoreTimeline;
 struct CompileUnitContext;
 
+namespace fastl { class Arena; }
+
 namespace CompileScore
 {
+	//Decides which parsed events and names are worth keeping for the current export parameters
+	struct EventFilter
+	{ 
+		EventFilter();
+
+		bool KeepEvent(const CompileCategory category) const;
+		bool KeepName(const CompileCategory category) const;
+
+		CompileCategory gatherLimit;
+		bool            timelineEnabled;
+	};
+
 	U64 StoreString(ScoreData& scoreData, const char* str);
 	U64 StoreString(ScoreData& scoreData, const char* str, size_t length);
 	U64 StorePathString(ScoreData& scoreData, const char* str, size_t length);
@@ -14,6 +28,8 @@ namespace CompileScore
 	U64 StoreCategoryValueString(ScoreData& scoreData, const char* str, size_t length, CompileCategory category);
 	U64 StoreCategoryTagString(ScoreData& scoreData, const char* str, size_t length, CompileCategory category);
 
+	fastl::Arena& GetScratchArena();
+
 	void ProcessTimeline(ScoreData& scoreData, ScoreTimeline& timeline, const CompileUnitContext& context);
 	void FinalizeScoreData(ScoreData& scoreData);
 }
\ No newline at end of file
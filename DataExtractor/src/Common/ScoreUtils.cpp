@@ -0,0 +1,52 @@
+#include "ScoreUtils.h"
+
+namespace ScoreUtils
+{
+	// -----------------------------------------------------------------------------------------------------------
+	U32 PopCount(U64 value)
+	{
+		value = value - ((value >> 1u) & 0x5555555555555555ull);
+		value = (value & 0x3333333333333333ull) + ((value >> 2u) & 0x3333333333333333ull);
+		value = (value + (value >> 4u)) & 0x0f0f0f0f0f0f0f0full;
+		return static_cast<U32>((value * 0x0101010101010101ull) >> 56u);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	U32 CountTrailingZeros(const U64 value)
+	{
+		//the bits below the lowest set one
+		return PopCount(~value & (value - 1u));
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	void GetFolderParents(fastl::vector<U32>& parents, const TCompileFolders& folders)
+	{
+		parents.clear();
+		parents.resize(folders.size());
+		for (U32 i = 0u, sz = static_cast<U32>(folders.size()); i < sz; ++i)
+		{
+			for (const TIndexDataDictionary::value_type& child : folders[i].children)
+			{
+				parents[child.second] = i;
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	fastl::string GetFolderPath(const TCompileFolders& folders, const fastl::vector<U32>& parents, U32 folderId)
+	{
+		fastl::vector<U32> chain;
+		for (; folderId != 0u; folderId = parents[folderId])
+		{
+			chain.push_back(folderId);
+		}
+
+		fastl::string path;
+		for (size_t i = chain.size(); i > 0u; --i)
+		{
+			path += folders[chain[i - 1u]].name;
+			path += '/';
+		}
+		return path;
+	}
+}
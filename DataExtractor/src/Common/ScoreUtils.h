@@ -0,0 +1,20 @@
+#pragma once
+
+// Small helpers shared by the score processing and the reports built on top of its data
+
+#include "ScoreDefinitions.h"
+
+namespace ScoreUtils
+{
+	template <typename T> inline constexpr T Min(const T a, const T b) { return a < b? a : b; }
+	template <typename T> inline constexpr T Max(const T a, const T b) { return a < b? b : a; }
+
+	inline double ToMs(const double value) { return value / 1000.0; } //the score times are in microseconds
+
+	U32 PopCount(U64 value);
+	U32 CountTrailingZeros(const U64 value);
+
+	// Folder tree, folder 0 is the root and children are always created after their parents
+	void GetFolderParents(fastl::vector<U32>& parents, const TCompileFolders& folders);
+	fastl::string GetFolderPath(const TCompileFolders& folders, const fastl::vector<U32>& parents, U32 folderId); //empty for the root
+}
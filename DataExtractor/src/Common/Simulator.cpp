@@ -0,0 +1,413 @@
+#include "Simulator.h"
+
+#include <string.h>
+
+#include "../Common/ScoreDefinitions.h"
+#include "../Common/ScoreUtils.h"
+#include "../Common/Threading.h"
+#include "../Common/Timers.h"
+#include "../fastl/algorithm.h"
+
+#include "IOStream.h"
+#include "Profiler.h"
+
+namespace Simulator
+{
+	namespace Utils
+	{
+		enum
+		{
+			SCENARIOS_PER_TASK  = 32,
+			REPORT_MAX_HEADERS  = 50,
+			REPORT_MAX_FOLDERS  = 20,
+			MAX_INCLUDE_DEPTH   = 64,
+			FOLDER_SPEEDUP      = 2,
+		};
+
+		constexpr double HEADER_COST_THRESHOLD = 1e-3; //include paths contributing less than this fraction of the header cost are ignored
+
+		using ScoreUtils::Min;
+		using ScoreUtils::Max;
+		using ScoreUtils::ToMs;
+
+		// Flattened include graph, the includer maps are too slow to walk for every scenario
+		struct IncludeGraph
+		{
+			fastl::vector<U32>    unitOffsets;   //per include, range in unitIds/unitCosts ( direct inclusions from the unit )
+			fastl::vector<U32>    unitIds;
+			fastl::vector<U32>    unitCosts;
+			fastl::vector<U32>    parentOffsets; //per include, range in parentIds/parentRatios
+			fastl::vector<U32>    parentIds;
+			fastl::vector<double> parentRatios;  //share of the parent time spent including this header
+		};
+
+		struct Replay
+		{
+			const U64* baseDurations;
+			const U32* order;
+			U32        numUnits;
+			U32        numCores;
+		};
+
+		// Per task scratch memory, allocated once for a whole batch of scenarios
+		struct Scratch
+		{
+			explicit Scratch(const Replay& replay)
+				: durations(replay.numUnits)
+				, cost(replay.numUnits)
+				, marks(replay.numUnits)
+				, cores(replay.numCores)
+				, epoch(0u)
+			{}
+
+			struct PathEntry
+			{
+				U32    includeId;
+				U32    depth;
+				double weight;
+			};
+
+			fastl::vector<U64>       durations;
+			fastl::vector<double>    cost;
+			fastl::vector<U32>       marks;
+			fastl::vector<U32>       touched;
+			fastl::vector<U64>       cores;
+			fastl::vector<PathEntry> stack;
+			U32                      epoch;
+		};
+
+		// -----------------------------------------------------------------------------------------------------------
+		U64 GetUnitDuration(const CompileUnit& unit)
+		{
+			const U64 start = Min(unit.context.startTime[0], unit.context.startTime[1]);
+			const U64 finish = Max(unit.context.startTime[0] + unit.values[ToUnderlying(CompileCategory::FrontEnd)],
+			                       unit.context.startTime[1] + unit.values[ToUnderlying(CompileCategory::BackEnd)]);
+			return Max<U64>(finish - start, unit.values[ToUnderlying(CompileCategory::ExecuteCompiler)]);
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// Each unit goes to the core that becomes available first, the cores are kept as a min heap of finish times
+		U64 ListSchedule(const U64* durations, const Replay& replay, U64* cores)
+		{
+			const U32 numCores = replay.numCores;
+			memset(cores, 0, sizeof(U64) * numCores);
+
+			U64 wallTime = 0u;
+			for (U32 i = 0u; i < replay.numUnits; ++i)
+			{
+				const U64 finish = cores[0] + durations[replay.order[i]];
+				wallTime = Max(wallTime, finish);
+
+				//replace the root and sift it down
+				U32 index = 0u;
+				for (U32 child = 1u; child < numCores; child = (index << 1u) + 1u)
+				{
+					child += (child + 1u < numCores && cores[child + 1u] < cores[child]) ? 1u : 0u;
+					if (cores[child] >= finish) break;
+					cores[index] = cores[child];
+					index = child;
+				}
+				cores[index] = finish;
+			}
+
+			return wallTime;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void BuildIncludeGraph(IncludeGraph& graph, const ScoreData& scoreData)
+		{
+			const TCompileDatas& includeData = scoreData.globals[ToUnderlying(CompileCategory::Include)];
+			const size_t numIncludes = Min(scoreData.includers.size(), includeData.size());
+
+			graph.unitOffsets.reserve(numIncludes + 1u);
+			graph.parentOffsets.reserve(numIncludes + 1u);
+
+			for (size_t i = 0u; i < numIncludes; ++i)
+			{
+				const CompileIncluder& includer = scoreData.includers[i];
+
+				graph.unitOffsets.push_back(static_cast<U32>(graph.unitIds.size()));
+				for (const TCompileIncluderUnitMap::value_type& pair : includer.units)
+				{
+					graph.unitIds.push_back(pair.first);
+					graph.unitCosts.push_back(pair.second);
+				}
+
+				graph.parentOffsets.push_back(static_cast<U32>(graph.parentIds.size()));
+				for (const TCompileIncluderInclMap::value_type& pair : includer.includes)
+				{
+					const U64 parentTime = pair.first < includeData.size() ? includeData[pair.first].accumulated : 0u;
+					if (parentTime)
+					{
+						graph.parentIds.push_back(pair.first);
+						graph.parentRatios.push_back(Min(static_cast<double>(pair.second.accumulated) / static_cast<double>(parentTime), 1.0));
+					}
+				}
+			}
+
+			graph.unitOffsets.push_back(static_cast<U32>(graph.unitIds.size()));
+			graph.parentOffsets.push_back(static_cast<U32>(graph.parentIds.size()));
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// Cost of a header in each unit: its direct inclusions plus its share of every includer header cost up the include paths
+		void ComputeHeaderCost(Scratch& scratch, const IncludeGraph& graph, const TCompileDatas& includeData, const U32 includeId)
+		{
+			++scratch.epoch;
+			scratch.touched.clear();
+			scratch.stack.clear();
+			scratch.stack.push_back({ includeId, 0u, 1.0 });
+
+			const double threshold = static_cast<double>(includeData[includeId].accumulated) * HEADER_COST_THRESHOLD;
+
+			while (!scratch.stack.empty())
+			{
+				const Scratch::PathEntry entry = scratch.stack.back();
+				scratch.stack.pop_back();
+
+				for (U32 i = graph.unitOffsets[entry.includeId], end = graph.unitOffsets[entry.includeId + 1u]; i < end; ++i)
+				{
+					const U32 unitId = graph.unitIds[i];
+					if (scratch.marks[unitId] != scratch.epoch)
+					{
+						scratch.marks[unitId] = scratch.epoch;
+						scratch.cost[unitId] = 0.0;
+						scratch.touched.push_back(unitId);
+					}
+					scratch.cost[unitId] += entry.weight * graph.unitCosts[i];
+				}
+
+				if (entry.depth < MAX_INCLUDE_DEPTH)
+				{
+					for (U32 i = graph.parentOffsets[entry.includeId], end = graph.parentOffsets[entry.includeId + 1u]; i < end; ++i)
+					{
+						const U32 parentId = graph.parentIds[i];
+						const double weight = entry.weight * graph.parentRatios[i];
+						if (weight * static_cast<double>(includeData[parentId].accumulated) >= threshold)
+						{
+							scratch.stack.push_back({ parentId, entry.depth + 1u, weight });
+						}
+					}
+				}
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U64 SimulateHeaderRemoval(Scratch& scratch, const Replay& replay)
+		{
+			memcpy(&scratch.durations[0], replay.baseDurations, sizeof(U64) * replay.numUnits);
+			for (const U32 unitId : scratch.touched)
+			{
+				const U64 cost = static_cast<U64>(scratch.cost[unitId]);
+				scratch.durations[unitId] -= Min(cost, scratch.durations[unitId]);
+			}
+			return ListSchedule(&scratch.durations[0], replay, &scratch.cores[0]);
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U64 SimulateFolderSpeedUp(Scratch& scratch, const Replay& replay, const TCompileFolders& folders, const U32 folderId)
+		{
+			memcpy(&scratch.durations[0], replay.baseDurations, sizeof(U64) * replay.numUnits);
+
+			fastl::vector<U32>& pending = scratch.touched;
+			pending.clear();
+			pending.push_back(folderId);
+			while (!pending.empty())
+			{
+				const CompileFolder& folder = folders[pending.back()];
+				pending.pop_back();
+
+				for (const U32 unitId : folder.unitIds)
+				{
+					scratch.durations[unitId] /= FOLDER_SPEEDUP;
+				}
+
+				for (const TIndexDataDictionary::value_type& child : folder.children)
+				{
+					pending.push_back(child.second);
+				}
+			}
+
+			return ListSchedule(&scratch.durations[0], replay, &scratch.cores[0]);
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		double GetBenefitMs(const U64 baseline, const U64 wallTime) { return (static_cast<double>(baseline) - static_cast<double>(wallTime)) / 1000.0; }
+
+		// -----------------------------------------------------------------------------------------------------------
+		void SortByWallTime(fastl::vector<U32>& ids, const fastl::vector<U64>& wallTimes)
+		{
+			fastl::sort(ids.begin(), ids.end(), [&](const U32 a, const U32 b) { return wallTimes[a] < wallTimes[b] || (wallTimes[a] == wallTimes[b] && a < b); });
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool WriteReport(const ScoreData& scoreData, unsigned int numCores, const char* filename)
+	{
+		PROFILE_ZONE("Simulate");
+
+		const U32 numUnits = static_cast<U32>(scoreData.units.size());
+		if (numUnits == 0u || numCores == 0u)
+		{
+			return false;
+		}
+
+		Time::Timer timer;
+		timer.Capture();
+
+		//replay the units in the order they actually started
+		fastl::vector<U64> durations(numUnits);
+		fastl::vector<U64> startTimes(numUnits);
+		fastl::vector<U32> order(numUnits);
+		for (const CompileUnit& unit : scoreData.units)
+		{
+			durations[unit.unitId] = Utils::GetUnitDuration(unit);
+			startTimes[unit.unitId] = Utils::Min(unit.context.startTime[0], unit.context.startTime[1]);
+			order[unit.unitId] = unit.unitId;
+		}
+		fastl::sort(order.begin(), order.end(), [&](const U32 a, const U32 b) { return startTimes[a] < startTimes[b] || (startTimes[a] == startTimes[b] && a < b); });
+
+		fastl::vector<U32> longestFirst = order;
+		fastl::sort(longestFirst.begin(), longestFirst.end(), [&](const U32 a, const U32 b) { return durations[a] > durations[b] || (durations[a] == durations[b] && a < b); });
+
+		const Utils::Replay replay = { &durations[0], &order[0], numUnits, numCores };
+		const Utils::Replay longestFirstReplay = { &durations[0], &longestFirst[0], numUnits, numCores };
+
+		fastl::vector<U64> cores(numCores);
+		const U64 baseline = Utils::ListSchedule(&durations[0], replay, &cores[0]);
+		const U64 longestFirstTime = Utils::ListSchedule(&durations[0], longestFirstReplay, &cores[0]);
+
+		U64 totalDuration = 0u;
+		U64 longestDuration = 0u;
+		for (const U64 duration : durations)
+		{
+			totalDuration += duration;
+			longestDuration = Utils::Max(longestDuration, duration);
+		}
+		const U64 lowerBound = Utils::Max(longestDuration, (totalDuration + numCores - 1u) / numCores);
+
+		//header removal scenarios
+		const TCompileDatas& includeData = scoreData.globals[ToUnderlying(CompileCategory::Include)];
+		Utils::IncludeGraph graph;
+		Utils::BuildIncludeGraph(graph, scoreData);
+
+		//without includers data ( -ni ) there is no per unit cost to remove
+		fastl::vector<U32> headerIds;
+		for (U32 i = 0u, sz = graph.unitIds.empty() ? 0u : static_cast<U32>(graph.unitOffsets.size()) - 1u; i < sz; ++i)
+		{
+			if (includeData[i].accumulated) headerIds.push_back(i);
+		}
+
+		fastl::vector<U64> headerWallTimes(includeData.size());
+		fastl::vector<U32> headerUnits(includeData.size());
+		fastl::vector<U64> headerCosts(includeData.size());
+		auto simulateHeaders = [&](const size_t task)
+		{
+			Utils::Scratch scratch(replay);
+			const size_t begin = task * Utils::SCENARIOS_PER_TASK;
+			const size_t end = Utils::Min<size_t>(begin + Utils::SCENARIOS_PER_TASK, headerIds.size());
+			for (size_t i = begin; i < end; ++i)
+			{
+				const U32 includeId = headerIds[i];
+				Utils::ComputeHeaderCost(scratch, graph, includeData, includeId);
+
+				U64 cost = 0u;
+				for (const U32 unitId : scratch.touched)
+				{
+					cost += Utils::Min(static_cast<U64>(scratch.cost[unitId]), durations[unitId]);
+				}
+				headerCosts[includeId] = cost;
+				headerUnits[includeId] = static_cast<U32>(scratch.touched.size());
+				headerWallTimes[includeId] = Utils::SimulateHeaderRemoval(scratch, replay);
+			}
+		};
+		Threading::ParallelFor("Simulate Headers", (headerIds.size() + Utils::SCENARIOS_PER_TASK - 1u) / Utils::SCENARIOS_PER_TASK, simulateHeaders);
+
+		//folder speed up scenarios, a chain of folders with a single child and no units is the same scenario as its child
+		const TCompileFolders& folders = scoreData.folders;
+		fastl::vector<U32> folderParents;
+		ScoreUtils::GetFolderParents(folderParents, folders);
+		fastl::vector<U32> folderUnits(folders.size());
+		for (U32 i = static_cast<U32>(folders.size()); i > 0u; --i)
+		{
+			//children are always created after their parents
+			const U32 folderId = i - 1u;
+			folderUnits[folderId] += static_cast<U32>(folders[folderId].unitIds.size());
+			if (folderId) folderUnits[folderParents[folderId]] += folderUnits[folderId];
+		}
+
+		fastl::vector<U32> folderIds;
+		for (U32 i = 0u, sz = static_cast<U32>(folders.size()); i < sz; ++i)
+		{
+			const bool isChain = folders[i].unitIds.empty() && folders[i].children.size() == 1u;
+			if (folderUnits[i] && !isChain) folderIds.push_back(i);
+		}
+
+		fastl::vector<U64> folderWallTimes(folders.size());
+		auto simulateFolders = [&](const size_t task)
+		{
+			Utils::Scratch scratch(replay);
+			const size_t begin = task * Utils::SCENARIOS_PER_TASK;
+			const size_t end = Utils::Min<size_t>(begin + Utils::SCENARIOS_PER_TASK, folderIds.size());
+			for (size_t i = begin; i < end; ++i)
+			{
+				folderWallTimes[folderIds[i]] = Utils::SimulateFolderSpeedUp(scratch, replay, folders, folderIds[i]);
+			}
+		};
+		Threading::ParallelFor("Simulate Folders", (folderIds.size() + Utils::SCENARIOS_PER_TASK - 1u) / Utils::SCENARIOS_PER_TASK, simulateFolders);
+
+		timer.Capture();
+		LOG_INFO("Simulated %u scenarios on %u cores", static_cast<U32>(headerIds.size() + folderIds.size() + 2u), numCores);
+		IO::LogTime(IO::Verbosity::Info, "Simulation Time: ", timer.GetElapsed());
+		LOG_INFO("");
+
+		//report
+		IO::TextOutputStream stream(filename);
+		if (!stream.IsValid())
+		{
+			LOG_ERROR("Unable to create the simulation report %s", filename);
+			return false;
+		}
+
+		stream.Append("Build Simulation Report\n=======================\n\n");
+		stream.AppendFormat("Cores: %u ( observed peak concurrency %u )\n", numCores, scoreData.concurrency.peak);
+		stream.AppendFormat("Units: %u, %.1f ms of compilation ( longest %.1f ms )\n", numUnits, Utils::ToMs(totalDuration), Utils::ToMs(longestDuration));
+		stream.AppendFormat("Observed wall time: %.1f ms\n", Utils::ToMs(scoreData.session.fullDuration));
+		stream.AppendFormat("Replayed wall time: %.1f ms ( observed start order )\n", Utils::ToMs(baseline));
+		stream.AppendFormat("Longest first: %.1f ms ( %.1f ms benefit )\n", Utils::ToMs(longestFirstTime), Utils::GetBenefitMs(baseline, longestFirstTime));
+		stream.AppendFormat("Lower bound: %.1f ms\n", Utils::ToMs(lowerBound));
+		if (scoreData.session.IsSampled())
+		{
+			stream.AppendFormat("Sampled session: only the %u sampled units are replayed\n", scoreData.session.sampledFiles);
+		}
+
+		Utils::SortByWallTime(headerIds, headerWallTimes);
+		const U32 numHeaders = Utils::Min<U32>(static_cast<U32>(headerIds.size()), Utils::REPORT_MAX_HEADERS);
+		stream.AppendFormat("\nHeader Removal ( %u of %u )\n\n", numHeaders, static_cast<U32>(headerIds.size()));
+		if (graph.unitIds.empty())
+		{
+			stream.Append("No includers data found, the header scenarios need the includers ( no -ni ).\n");
+		}
+		stream.Append("      Wall(ms)    Benefit(ms)       Cost(ms)    Units  Header\n");
+		for (U32 i = 0u; i < numHeaders; ++i)
+		{
+			const U32 includeId = headerIds[i];
+			TCompileStrings::const_iterator found = scoreData.strings.find(includeData[includeId].nameHash);
+			stream.AppendFormat("%14.1f %14.1f %14.1f %8u  %s\n", Utils::ToMs(headerWallTimes[includeId]), Utils::GetBenefitMs(baseline, headerWallTimes[includeId]),
+				Utils::ToMs(headerCosts[includeId]), headerUnits[includeId], found == scoreData.strings.end() ? "?" : found->second.c_str());
+		}
+
+		Utils::SortByWallTime(folderIds, folderWallTimes);
+		const U32 numFolders = Utils::Min<U32>(static_cast<U32>(folderIds.size()), Utils::REPORT_MAX_FOLDERS);
+		stream.AppendFormat("\nFolder Speed Up x%u ( %u of %u )\n\n", static_cast<U32>(Utils::FOLDER_SPEEDUP), numFolders, static_cast<U32>(folderIds.size()));
+		stream.Append("      Wall(ms)    Benefit(ms)    Units  Folder\n");
+		for (U32 i = 0u; i < numFolders; ++i)
+		{
+			const U32 folderId = folderIds[i];
+			const fastl::string path = folderId ? ScoreUtils::GetFolderPath(folders, folderParents, folderId) : fastl::string("( all units )");
+			stream.AppendFormat("%14.1f %14.1f %8u  %s\n", Utils::ToMs(folderWallTimes[folderId]), Utils::GetBenefitMs(baseline, folderWallTimes[folderId]), folderUnits[folderId], path.c_str());
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Build wall time simulator, replays the extracted units on a fixed number of cores with list scheduling
+// Each what-if scenario ( header removed, folder sped up, longest first order ) is a full replay ranked by its wall time benefit
+
+struct ScoreData;
+
+namespace Simulator
+{
+	bool WriteReport(const ScoreData& scoreData, unsigned int numCores, const char* filename);
+}
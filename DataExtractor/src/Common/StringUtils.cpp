@@ -1,9 +1,48 @@
 #include "StringUtils.h"
 
+#include <string.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#include <stdlib.h>
+#define STRINGUTILS_USE_CXA_DEMANGLE
+#endif
+
 #include "BasicTypes.h"
 
+#include "SIMD.h"
+
 namespace StringUtils
 { 
+#ifdef SIMD_USE_SSE2
+    namespace SIMD
+    { 
+        using namespace ::SIMD;
+
+        // -----------------------------------------------------------------------------------------------------------
+        inline __m128i ToLower(const __m128i block)
+        { 
+            //signed compares leave any non ascii byte untouched
+            const __m128i isUpper = _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(block, _mm_set1_epi8('Z' + 1)));
+            return _mm_add_epi8(block, _mm_and_si128(isUpper, _mm_set1_epi8('a' - 'A')));
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        inline __m128i ToForwardSlashes(const __m128i block)
+        { 
+            const __m128i isBackSlash = _mm_cmpeq_epi8(block, _mm_set1_epi8('\\'));
+            return _mm_or_si128(_mm_andnot_si128(isBackSlash, block), _mm_and_si128(isBackSlash, _mm_set1_epi8('/')));
+        }
+
+        // -----------------------------------------------------------------------------------------------------------
+        inline U32 CountUntilAngleBracket(const __m128i block)
+        { 
+            const U32 mask = FindMask(block, '<') | FindMask(block, '>');
+            return mask ? FirstSetBit(mask) : static_cast<U32>(BLOCK_SIZE);
+        }
+    }
+#endif
+
     // -----------------------------------------------------------------------------------------------------------
     void ToPathBaseName(fastl::string& path)
     { 
@@ -47,12 +86,43 @@ namespace StringUtils
     // -----------------------------------------------------------------------------------------------------------
     void ToLower(fastl::string& input)
     {
-        for (size_t i = 0,sz=input.length(); i < sz; ++ i) 
+        size_t i = 0;
+        const size_t sz = input.length();
+
+#ifdef SIMD_USE_SSE2
+        char* str = &input[0];
+        for (; i + SIMD::BLOCK_SIZE <= sz; i += SIMD::BLOCK_SIZE)
+        { 
+            SIMD::Store(str + i, SIMD::ToLower(SIMD::Load(str + i)));
+        }
+#endif
+
+        for (; i < sz; ++ i) 
         {
             input[i] = ToLower(input[i]);  
         }
     }
 
+    // -----------------------------------------------------------------------------------------------------------
+    void ToLowerForwardSlashes(fastl::string& input)
+    { 
+        size_t i = 0;
+        const size_t sz = input.length();
+
+#ifdef SIMD_USE_SSE2
+        char* str = &input[0];
+        for (; i + SIMD::BLOCK_SIZE <= sz; i += SIMD::BLOCK_SIZE)
+        { 
+            SIMD::Store(str + i, SIMD::ToLower(SIMD::ToForwardSlashes(SIMD::Load(str + i))));
+        }
+#endif
+
+        for (; i < sz; ++i)
+        {
+            input[i] = input[i] == '\\' ? '/' : ToLower(input[i]);
+        }
+    }
+
 	// -----------------------------------------------------------------------------------------------------------
 	void NormalizePath(fastl::string& input)
 	{
@@ -63,6 +133,9 @@ namespace StringUtils
         };
         static_assert(( FOLDER_BUFFER_SIZE & (FOLDER_BUFFER_SIZE - 1) ) == 0u, "FOLDER_BUFFER_SIZE must be a power of 2");        
 
+        //Convert everything to lower case forward slashes upfront, the loop below only needs to deal with the folder structure
+        ToLowerForwardSlashes(input);
+
         size_t folderBuffer[FOLDER_BUFFER_SIZE];
         U8 head = 0; 
         U8 tail = 0;
@@ -70,16 +143,33 @@ namespace StringUtils
         size_t writeIndex = 0; 
         bool wasForwardSlash = false;
         const size_t sz = input.length();
+        char* str = &input[0];
         for (size_t i = 0; i < sz; ++i)
         {
-            //Convert everything to forward slashes
-            if (input[i] == '\\')
-            {
-                input[i] = '/';
+#ifdef SIMD_USE_SSE2
+            //Bulk move all characters until the next folder split
+            if (!wasForwardSlash)
+            { 
+                for (; i + SIMD::BLOCK_SIZE <= sz; i += SIMD::BLOCK_SIZE, writeIndex += SIMD::BLOCK_SIZE)
+                { 
+                    const __m128i block = SIMD::Load(str + i);
+                    if (const U32 slashMask = SIMD::FindMask(block, '/'))
+                    {
+                        const U32 count = SIMD::FirstSetBit(slashMask);
+                        for (U32 k = 0; k < count; ++k) str[writeIndex + k] = str[i + k];
+                        i += count;
+                        writeIndex += count;
+                        break;
+                    }
+                    if (writeIndex != i) SIMD::Store(str + writeIndex, block);
+                }
+
+                if (i >= sz) break;
             }
+#endif
 
             //remove consecutive forward slashes
-            const bool isForwardSlash = input[i] == '/';
+            const bool isForwardSlash = str[i] == '/';
             if (wasForwardSlash)
             {
                 if (isForwardSlash)
@@ -88,18 +178,18 @@ namespace StringUtils
                 }
 
                 //Handle directory changes
-				if (input[i] == '.')
+				if (str[i] == '.')
 				{
-                    //Check for . ./ .\ or end of string to omit this character 
+                    //Check for . ./ or end of string to omit this character 
                     size_t nextIndex = i + 1;
-                    if (nextIndex >= sz || input[nextIndex] == '/' || input[nextIndex] == '\\')
+                    if (nextIndex >= sz || str[nextIndex] == '/')
                     {
                         continue;
                     }
 
-					//Check for .. ../ ..\ and move the writecursor back to the previous folder
+					//Check for .. ../ and move the writecursor back to the previous folder
                     size_t nextNextIndex = nextIndex + 1;
-					if (input[nextIndex] == '.' && (nextNextIndex >= sz || input[nextNextIndex] == '/' || input[nextNextIndex] == '\\'))
+					if (str[nextIndex] == '.' && (nextNextIndex >= sz || str[nextNextIndex] == '/'))
 					{
                         //retrieve the previous folder point if we have it
                         head = (head - 1) & FOLDER_BUFFER_MASK;
@@ -122,8 +212,7 @@ namespace StringUtils
                 folderBuffer[head] = writeIndex;
             }
 
-            //lower case the full path 
-			input[writeIndex] = ToLower(input[i]);
+			str[writeIndex] = str[i];
             ++writeIndex; 
             wasForwardSlash = isForwardSlash;
 		}
@@ -140,15 +229,42 @@ namespace StringUtils
         int indentLevel = 0; 
 		size_t writeIndex = 0;
         const size_t sz = input.length();
+        char* str = &input[0];
 		for (size_t i = 0; i < sz; ++i)
 		{
-			if (input[i] == '<') ++indentLevel;
+#ifdef SIMD_USE_SSE2
+            //Bulk copy or skip everything until the next angle bracket
+            for (; i + SIMD::BLOCK_SIZE <= sz; i += SIMD::BLOCK_SIZE)
+            { 
+                const __m128i block = SIMD::Load(str + i);
+                const U32 count = SIMD::CountUntilAngleBracket(block);
+                if (indentLevel == 0)
+                { 
+                    if (writeIndex != i) 
+                    { 
+                        if (count == SIMD::BLOCK_SIZE) SIMD::Store(str + writeIndex, block);
+                        else for (U32 k = 0; k < count; ++k) str[writeIndex + k] = str[i + k];
+                    }
+                    writeIndex += count;
+                }
+
+                if (count < SIMD::BLOCK_SIZE)
+                { 
+                    i += count;
+                    break;
+                }
+            }
+
+            if (i >= sz) break;
+#endif
+
+			if (str[i] == '<') ++indentLevel;
             if (indentLevel == 0)
             {
-			    input[writeIndex] = input[i];
+			    str[writeIndex] = str[i];
                 ++writeIndex;
             }
-			if (input[i] == '>') --indentLevel;
+			if (str[i] == '>') --indentLevel;
 		}
 
 		if (writeIndex < sz)
@@ -156,4 +272,84 @@ namespace StringUtils
 			input.erase(writeIndex, sz - writeIndex);
 		}
     }
+
+    // -----------------------------------------------------------------------------------------------------------
+    bool IsOperatorName(const char* str)
+    {
+        const char* keyword = "operator";
+        for (; *keyword != '\0'; ++keyword, ++str)
+        {
+            if (*str != *keyword) return false;
+        }
+
+        //'operators' or 'operator_x' are plain identifiers
+        return !IsIdentifierChar(*str);
+    }
+
+    // -----------------------------------------------------------------------------------------------------------
+    bool Demangle(fastl::string& input)
+    {
+#ifdef STRINGUTILS_USE_CXA_DEMANGLE
+        if (input.length() < 2u || input[0] != '_' || input[1] != 'Z')
+        {
+            return false;
+        }
+
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(input.c_str(), nullptr, nullptr, &status);
+        if (demangled == nullptr || status != 0)
+        {
+            free(demangled);
+            return false;
+        }
+
+        //Keep only the qualified name, the frontend events have no return type nor parameters ( 'void ns::f<int>(int) const' -> 'ns::f<int>' )
+        size_t nameStart = 0u;
+        size_t nameEnd = 0u;
+        int depth = 0;
+        size_t i = 0u;
+        for (; demangled[i] != '\0'; ++i)
+        {
+            const char c = demangled[i];
+            if (depth == 0 && (i == 0u || !IsIdentifierChar(demangled[i - 1u])) && IsOperatorName(demangled + i))
+            {
+                //the operator symbols do not nest ( operator<, operator(), operator new... )
+                i += 7u;
+                if (demangled[i + 1u] == '(' && demangled[i + 2u] == ')') i += 2u;
+                else if (demangled[i + 1u] == ' ') while (demangled[i + 1u] != '\0' && demangled[i + 1u] != '(' && demangled[i + 1u] != '<') ++i;
+                else while (demangled[i + 1u] != '\0' && demangled[i + 1u] != '(' && strchr("<>=!+-*/%^&|~,[]", demangled[i + 1u])) ++i;
+            }
+            else if (c == '<' || c == '(')
+            {
+                nameEnd = depth == 0 && c == '(' ? i : nameEnd;
+                ++depth;
+            }
+            else if (c == '>' || c == ')')
+            {
+                depth -= depth > 0 ? 1 : 0;
+            }
+            else if (c == ' ' && depth == 0 && nameEnd <= nameStart)
+            {
+                //everything before is the return type
+                nameStart = i + 1u;
+            }
+        }
+
+        nameEnd = nameEnd > nameStart ? nameEnd : i;
+        //the frontend spells nested templates without the pre C++11 space ( 'std::vector<std::pair<int, int> >' -> 'std::vector<std::pair<int, int>>' )
+        input.clear();
+        for (i = nameStart; i < nameEnd; ++i)
+        {
+            if (demangled[i] != ' ' || i == nameStart || demangled[i - 1u] != '>' || demangled[i + 1u] != '>')
+            {
+                input += demangled[i];
+            }
+        }
+        free(demangled);
+        return true;
+#else
+        //no itanium demangler available with this compiler, the names stay mangled
+        return false;
+#endif
+    }
 }
@@ -9,4 +9,8 @@ namespace StringUtils
     void ToLower(fastl::string& input);
     void NormalizePath(fastl::string& path);
     void CollapseTemplates(fastl::string& input);
+    bool Demangle(fastl::string& input); //itanium mangled name to its qualified function name, false if it could not be demangled
+
+    inline bool IsIdentifierChar(const char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_'; }
+    bool IsOperatorName(const char* str); //'operator' keyword at str, not just an identifier starting with it
 }
\ No newline at end of file
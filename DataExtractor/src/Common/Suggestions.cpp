@@ -0,0 +1,655 @@
+#include "Suggestions.h"
+
+#include "../Common/ScoreDefinitions.h"
+#include "../Common/ScoreUtils.h"
+#include "../Common/Threading.h"
+#include "../fastl/algorithm.h"
+
+#include "IOStream.h"
+#include "Profiler.h"
+#include "Timers.h"
+
+namespace Suggestions
+{
+	namespace Utils
+	{
+		enum
+		{
+			MIN_GROUP_UNITS    = 2,
+			REPORT_MAX_GROUPS  = 20,
+			REPORT_MAX_HEADERS = 30,
+
+			SIGNATURE_SIZE       = 32, //one permutation MinHash bins per unit
+			LSH_BANDS            = 8,
+			LSH_ROWS             = SIGNATURE_SIZE / LSH_BANDS,
+			MAX_BUCKET_NEIGHBORS = 8,  //candidate pairs per unit and band, keeps huge buckets of identical units linear
+			REPORT_MAX_UNITS     = 16,
+		};
+
+		static_assert(SIGNATURE_SIZE == 32, "The bin is taken from the top 5 bits of the include hash");
+
+		constexpr double UNUSED_HEADER_PENALTY = 0.1; //share of a header parse time paid by each unit getting it from the PCH without including it
+		constexpr double MIN_UNITY_SIMILARITY  = 0.5; //estimated include set jaccard index to merge two units
+		constexpr U32    EMPTY_BIN             = 0xffffffff;
+
+		using ScoreUtils::Min;
+		using ScoreUtils::Max;
+		using ScoreUtils::ToMs;
+		using ScoreUtils::CountTrailingZeros;
+
+		// Direct inclusions of each unit, inverted from the includers data
+		struct UnitIncludes
+		{
+			fastl::vector<U32> offsets;
+			fastl::vector<U32> includeIds;
+			fastl::vector<U32> costs;
+		};
+
+		struct PCHHeader
+		{
+			U32    includeId;
+			U32    users; //units in the group including it
+			U64    saved;
+			U64    size;
+			double value; //saved time minus the unused penalty
+		};
+
+		struct PCHSuggestion
+		{
+			PCHSuggestion() : folderId(0u), numUnits(0u), value(0.0), size(0u) {}
+
+			U32                      folderId;
+			U32                      numUnits;
+			double                   value;
+			U64                      size;
+			fastl::vector<PCHHeader> headers;
+		};
+
+		struct UnityEdge
+		{
+			U32    unitA;
+			U32    unitB;
+			double similarity;
+		};
+
+		struct UnityGroup
+		{
+			U32                folderId;
+			U64                saved;
+			U64                frontEnd;
+			fastl::vector<U32> unitIds;
+		};
+
+		// -----------------------------------------------------------------------------------------------------------
+		void BuildUnitIncludes(UnitIncludes& unitIncludes, const ScoreData& scoreData)
+		{
+			const U32 numUnits = static_cast<U32>(scoreData.units.size());
+			const U32 numIncludes = static_cast<U32>(scoreData.includers.size());
+
+			unitIncludes.offsets.resize(numUnits + 1u);
+			for (const CompileIncluder& includer : scoreData.includers)
+			{
+				for (const TCompileIncluderUnitMap::value_type& pair : includer.units)
+				{
+					++unitIncludes.offsets[pair.first + 1u];
+				}
+			}
+			for (U32 i = 0u; i < numUnits; ++i)
+			{
+				unitIncludes.offsets[i + 1u] += unitIncludes.offsets[i];
+			}
+
+			unitIncludes.includeIds.resize(unitIncludes.offsets[numUnits]);
+			unitIncludes.costs.resize(unitIncludes.offsets[numUnits]);
+			fastl::vector<U32> cursor = unitIncludes.offsets;
+			for (U32 includeId = 0u; includeId < numIncludes; ++includeId)
+			{
+				for (const TCompileIncluderUnitMap::value_type& pair : scoreData.includers[includeId].units)
+				{
+					const U32 index = cursor[pair.first]++;
+					unitIncludes.includeIds[index] = includeId;
+					unitIncludes.costs[index] = pair.second;
+				}
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// Knapsack over the headers used by the group: greedy by value density, compared against the best single header that fits
+		void SuggestPCH(PCHSuggestion& suggestion, const ScoreData& scoreData, const UnitIncludes& unitIncludes, const fastl::vector<U32>& unitIds, const U64 budget)
+		{
+			const TCompileDatas& includeData = scoreData.globals[ToUnderlying(CompileCategory::Include)];
+			const U32 numIncludes = static_cast<U32>(scoreData.includers.size());
+
+			fastl::vector<U32> users(numIncludes);
+			fastl::vector<U64> saved(numIncludes);
+			fastl::vector<U32> touched;
+
+			for (const U32 unitId : unitIds)
+			{
+				for (U32 i = unitIncludes.offsets[unitId], end = unitIncludes.offsets[unitId + 1u]; i < end; ++i)
+				{
+					const U32 includeId = unitIncludes.includeIds[i];
+					if (users[includeId] == 0u) touched.push_back(includeId);
+					++users[includeId];
+					saved[includeId] += unitIncludes.costs[i];
+				}
+			}
+
+			suggestion.numUnits = static_cast<U32>(unitIds.size());
+
+			fastl::vector<PCHHeader> candidates;
+			for (const U32 includeId : touched)
+			{
+				const CompileData& data = includeData[includeId];
+				const U64 size = Max<U64>(data.count ? data.accumulated / data.count : 0u, 1u);
+				const double penalty = UNUSED_HEADER_PENALTY * static_cast<double>(size) * static_cast<double>(suggestion.numUnits - users[includeId]);
+				const double value = static_cast<double>(saved[includeId]) - penalty;
+				if (value > 0.0 && size <= budget)
+				{
+					candidates.push_back({ includeId, users[includeId], saved[includeId], size, value });
+				}
+			}
+
+			fastl::sort(candidates.begin(), candidates.end(), [](const PCHHeader& a, const PCHHeader& b)
+			{
+				const double densityA = a.value / static_cast<double>(a.size);
+				const double densityB = b.value / static_cast<double>(b.size);
+				return densityA > densityB || (densityA == densityB && a.includeId < b.includeId);
+			});
+
+			const PCHHeader* bestSingle = nullptr;
+			for (const PCHHeader& candidate : candidates)
+			{
+				if (bestSingle == nullptr || candidate.value > bestSingle->value) bestSingle = &candidate;
+
+				if (suggestion.size + candidate.size <= budget)
+				{
+					suggestion.size += candidate.size;
+					suggestion.value += candidate.value;
+					suggestion.headers.push_back(candidate);
+				}
+			}
+
+			if (bestSingle && bestSingle->value > suggestion.value)
+			{
+				suggestion.headers.clear();
+				suggestion.headers.push_back(*bestSingle);
+				suggestion.size = bestSingle->size;
+				suggestion.value = bestSingle->value;
+			}
+
+			fastl::sort(suggestion.headers.begin(), suggestion.headers.end(), [](const PCHHeader& a, const PCHHeader& b)
+			{
+				return a.value > b.value || (a.value == b.value && a.includeId < b.includeId);
+			});
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U64 Mix(U64 value)
+		{
+			value ^= value >> 33u;
+			value *= 0xff51afd7ed558ccdull;
+			value ^= value >> 33u;
+			value *= 0xc4ceb9fe1a85ec53ull;
+			value ^= value >> 33u;
+			return value;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		template <typename TFunc> void ForEachUnit(const CompileUnitSet& unitSet, const U32 numUnits, const TFunc& func)
+		{
+			for (const CompileUnitSet::Chunk& chunk : unitSet.chunks)
+			{
+				const U32 runEnd = Min((chunk.firstWord + chunk.fullWords) << 6u, numUnits);
+				for (U32 unitId = chunk.firstWord << 6u; unitId < runEnd; ++unitId)
+				{
+					func(unitId);
+				}
+
+				const U32 literalBase = (chunk.firstWord + chunk.fullWords) << 6u;
+				for (U64 literal = chunk.literal; literal; literal &= literal - 1u)
+				{
+					func(literalBase + CountTrailingZeros(literal));
+				}
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// One permutation MinHash: every include lands in a single bin by its hash, the empty bins borrow the next filled one ( rotation densification )
+		void BuildSignatures(fastl::vector<U32>& signatures, const ScoreData& scoreData)
+		{
+			const U32 numUnits = static_cast<U32>(scoreData.units.size());
+			signatures.resize(static_cast<size_t>(numUnits) * SIGNATURE_SIZE);
+			for (U32& entry : signatures)
+			{
+				entry = EMPTY_BIN;
+			}
+
+			for (U32 includeId = 0u, sz = static_cast<U32>(scoreData.includeCosts.size()); includeId < sz; ++includeId)
+			{
+				const U64 hash = Mix(scoreData.globals[ToUnderlying(CompileCategory::Include)][includeId].nameHash);
+				const U32 bin = static_cast<U32>(hash >> 59u);
+				const U32 value = static_cast<U32>(hash) & ~1u; //EMPTY_BIN is never a valid value
+
+				ForEachUnit(scoreData.includeCosts[includeId].units, numUnits, [&](const U32 unitId)
+				{
+					U32& entry = signatures[static_cast<size_t>(unitId) * SIGNATURE_SIZE + bin];
+					entry = Min(entry, value);
+				});
+			}
+
+			auto densify = [&](const size_t unitId)
+			{
+				U32* signature = &signatures[unitId * SIGNATURE_SIZE];
+				U32 original[SIGNATURE_SIZE];
+				for (U32 i = 0u; i < SIGNATURE_SIZE; ++i)
+				{
+					original[i] = signature[i];
+				}
+
+				for (U32 i = 0u; i < SIGNATURE_SIZE; ++i)
+				{
+					for (U32 distance = 1u; signature[i] == EMPTY_BIN && distance < SIGNATURE_SIZE; ++distance)
+					{
+						const U32 source = original[(i + distance) % SIGNATURE_SIZE];
+						if (source != EMPTY_BIN) signature[i] = (source + distance * 0x9e3779b9u) & ~1u;
+					}
+				}
+			};
+			Threading::ParallelFor("Unity Signatures", numUnits, densify);
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		double GetSimilarity(const fastl::vector<U32>& signatures, const U32 unitA, const U32 unitB)
+		{
+			const U32* signatureA = &signatures[static_cast<size_t>(unitA) * SIGNATURE_SIZE];
+			const U32* signatureB = &signatures[static_cast<size_t>(unitB) * SIGNATURE_SIZE];
+
+			U32 matches = 0u;
+			for (U32 i = 0u; i < SIGNATURE_SIZE; ++i)
+			{
+				matches += signatureA[i] == signatureB[i] ? 1u : 0u;
+			}
+			return static_cast<double>(matches) / static_cast<double>(SIGNATURE_SIZE);
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		// Units sharing all the rows of any band are candidates, only within the same folder
+		void FindCandidates(fastl::vector<UnityEdge>& edges, const fastl::vector<U32>& signatures, const fastl::vector<U32>& unitFolders)
+		{
+			const U32 numUnits = static_cast<U32>(unitFolders.size());
+
+			fastl::vector<U32> unitIds;
+			for (U32 unitId = 0u; unitId < numUnits; ++unitId)
+			{
+				if (signatures[static_cast<size_t>(unitId) * SIGNATURE_SIZE] != EMPTY_BIN) unitIds.push_back(unitId);
+			}
+
+			fastl::vector<U64> keys(unitIds.size());
+			fastl::vector<U32> order(unitIds.size());
+			fastl::vector<U64> links;
+			for (U32 band = 0u; band < LSH_BANDS; ++band)
+			{
+				for (size_t i = 0u, sz = unitIds.size(); i < sz; ++i)
+				{
+					const U32* rows = &signatures[static_cast<size_t>(unitIds[i]) * SIGNATURE_SIZE + band * LSH_ROWS];
+
+					U64 key = Mix(band + (static_cast<U64>(unitFolders[unitIds[i]]) << 8u));
+					for (U32 row = 0u; row < LSH_ROWS; ++row)
+					{
+						key = Mix(key ^ rows[row]);
+					}
+					keys[i] = key;
+					order[i] = static_cast<U32>(i);
+				}
+
+				fastl::sort(order.begin(), order.end(), [&](const U32 a, const U32 b) { return keys[a] < keys[b] || (keys[a] == keys[b] && a < b); });
+
+				//unitIds is sorted, so inside each bucket the first unit of the pair is always the lowest
+				for (size_t i = 0u, sz = order.size(); i < sz; ++i)
+				{
+					for (size_t j = i + 1u; j < sz && j <= i + MAX_BUCKET_NEIGHBORS && keys[order[j]] == keys[order[i]]; ++j)
+					{
+						links.push_back((static_cast<U64>(unitIds[order[i]]) << 32u) | unitIds[order[j]]);
+					}
+				}
+			}
+
+			fastl::sort(links.begin(), links.end());
+			edges.clear();
+			for (size_t i = 0u, sz = links.size(); i < sz; ++i)
+			{
+				if (i == 0u || links[i] != links[i - 1u])
+				{
+					edges.push_back({ static_cast<U32>(links[i] >> 32u), static_cast<U32>(links[i]), 0.0 });
+				}
+			}
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		U32 FindRoot(fastl::vector<U32>& parents, U32 unitId)
+		{
+			while (parents[unitId] != unitId)
+			{
+				parents[unitId] = parents[parents[unitId]];
+				unitId = parents[unitId];
+			}
+			return unitId;
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		fastl::string GetGroupName(const TCompileFolders& folders, const fastl::vector<U32>& parents, const U32 folderId)
+		{
+			return folderId == 0u? fastl::string("All units") : ScoreUtils::GetFolderPath(folders, parents, folderId);
+		}
+
+		// -----------------------------------------------------------------------------------------------------------
+		void AppendPCHSuggestion(IO::TextOutputStream& stream, const ScoreData& scoreData, const PCHSuggestion& suggestion, const fastl::string& name)
+		{
+			const TCompileDatas& includeData = scoreData.globals[ToUnderlying(CompileCategory::Include)];
+
+			stream.AppendFormat("\n%s ( %u units ): %.1f ms saved, %u headers, %.1f ms size\n\n", name.c_str(), suggestion.numUnits, ToMs(suggestion.value),
+				static_cast<U32>(suggestion.headers.size()), ToMs(static_cast<double>(suggestion.size)));
+
+			if (suggestion.headers.empty()) return;
+
+			stream.Append("     Saved(ms)       Size(ms)    Units  Header\n");
+			const size_t numHeaders = Min<size_t>(suggestion.headers.size(), REPORT_MAX_HEADERS);
+			for (size_t i = 0u; i < numHeaders; ++i)
+			{
+				const PCHHeader& header = suggestion.headers[i];
+				TCompileStrings::const_iterator found = scoreData.strings.find(includeData[header.includeId].nameHash);
+				stream.AppendFormat("%14.1f %14.1f %8u  %s\n", ToMs(header.value), ToMs(static_cast<double>(header.size)), header.users, found == scoreData.strings.end() ? "?" : found->second.c_str());
+			}
+
+			if (numHeaders < suggestion.headers.size())
+			{
+				stream.AppendFormat("  ... %u more\n", static_cast<U32>(suggestion.headers.size() - numHeaders));
+			}
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool WritePCHReport(const ScoreData& scoreData, unsigned int budget, const char* filename)
+	{
+		PROFILE_ZONE("SuggestPCH");
+
+		IO::TextOutputStream stream(filename);
+		if (!stream.IsValid())
+		{
+			LOG_ERROR("Unable to create the PCH report %s", filename);
+			return false;
+		}
+
+		stream.Append("PCH Suggestions\n===============\n\n");
+		stream.AppendFormat("Budget: %u ms per PCH, the size of a header is its average inclusive parse time\n", budget);
+		stream.AppendFormat("Savings: direct inclusion time of the header in the units, minus %.0f%% of its size for every unit not including it\n", Utils::UNUSED_HEADER_PENALTY * 100.0);
+
+		const TCompileFolders& folders = scoreData.folders;
+		U32 numDirectInclusions = 0u;
+		for (const CompileIncluder& includer : scoreData.includers)
+		{
+			numDirectInclusions += static_cast<U32>(includer.units.size());
+		}
+
+		if (numDirectInclusions == 0u || folders.empty())
+		{
+			stream.Append("\nNo includers data found, the suggestions need the includers ( no -ni ).\n");
+			return true;
+		}
+
+		Utils::UnitIncludes unitIncludes;
+		Utils::BuildUnitIncludes(unitIncludes, scoreData);
+
+		//one candidate PCH for the whole project and one for each folder holding units
+		fastl::vector<U32> groupFolders;
+		groupFolders.push_back(0u);
+		for (U32 i = 1u, sz = static_cast<U32>(folders.size()); i < sz; ++i)
+		{
+			if (folders[i].unitIds.size() >= Utils::MIN_GROUP_UNITS) groupFolders.push_back(i);
+		}
+
+		fastl::vector<U32> allUnits(scoreData.units.size());
+		for (U32 i = 0u, sz = static_cast<U32>(allUnits.size()); i < sz; ++i)
+		{
+			allUnits[i] = i;
+		}
+
+		const U64 budgetTime = static_cast<U64>(budget) * 1000u;
+		fastl::vector<Utils::PCHSuggestion> suggestions(groupFolders.size());
+		auto suggestPCH = [&](const size_t index)
+		{
+			const U32 folderId = groupFolders[index];
+			suggestions[index].folderId = folderId;
+			Utils::SuggestPCH(suggestions[index], scoreData, unitIncludes, folderId ? folders[folderId].unitIds : allUnits, budgetTime);
+		};
+		Threading::ParallelFor("Suggest PCH Group", groupFolders.size(), suggestPCH);
+
+		fastl::vector<U32> folderParents;
+		ScoreUtils::GetFolderParents(folderParents, folders);
+
+		Utils::AppendPCHSuggestion(stream, scoreData, suggestions[0], Utils::GetGroupName(folders, folderParents, 0u));
+
+		//rank the folders by savings
+		fastl::vector<U32> ranking;
+		for (U32 i = 1u, sz = static_cast<U32>(suggestions.size()); i < sz; ++i)
+		{
+			if (!suggestions[i].headers.empty()) ranking.push_back(i);
+		}
+		fastl::sort(ranking.begin(), ranking.end(), [&](const U32 a, const U32 b)
+		{
+			return suggestions[a].value > suggestions[b].value || (suggestions[a].value == suggestions[b].value && a < b);
+		});
+
+		const size_t numGroups = Utils::Min<size_t>(ranking.size(), Utils::REPORT_MAX_GROUPS);
+		stream.AppendFormat("\nPer Folder ( %u of %u )\n", static_cast<U32>(numGroups), static_cast<U32>(ranking.size()));
+		for (size_t i = 0u; i < numGroups; ++i)
+		{
+			const Utils::PCHSuggestion& suggestion = suggestions[ranking[i]];
+			Utils::AppendPCHSuggestion(stream, scoreData, suggestion, Utils::GetGroupName(folders, folderParents, suggestion.folderId));
+		}
+
+		return true;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool WriteUnityReport(const ScoreData& scoreData, unsigned int maxGroupUnits, const char* filename)
+	{
+		PROFILE_ZONE("SuggestUnity");
+
+		IO::TextOutputStream stream(filename);
+		if (!stream.IsValid())
+		{
+			LOG_ERROR("Unable to create the unity build report %s", filename);
+			return false;
+		}
+
+		stream.Append("Unity Build Suggestions\n=======================\n\n");
+		stream.AppendFormat("Max units per group: %u, only units in the same folder are grouped\n", maxGroupUnits);
+		stream.AppendFormat("Similarity: MinHash of the transitive include set of each unit ( %u values ), LSH with %u bands, merged above %.0f%%\n", 
+			static_cast<U32>(Utils::SIGNATURE_SIZE), static_cast<U32>(Utils::LSH_BANDS), Utils::MIN_UNITY_SIMILARITY * 100.0);
+		stream.Append("Savings: average self parse time of each header included by more than one unit of the group, paid only once\n");
+
+		const TCompileFolders& folders = scoreData.folders;
+		const TCompileUnits& units = scoreData.units;
+		const TCompileDatas& includeData = scoreData.globals[ToUnderlying(CompileCategory::Include)];
+		const U32 numUnits = static_cast<U32>(units.size());
+
+		bool hasIncludeSets = false;
+		for (const CompileIncludeCost& includeCost : scoreData.includeCosts)
+		{
+			hasIncludeSets |= !includeCost.units.chunks.empty();
+		}
+
+		if (!hasIncludeSets || maxGroupUnits < 2u)
+		{
+			stream.Append("\nNo include sets found, the suggestions need the includers ( no -ni ).\n");
+			return true;
+		}
+
+		Time::Timer timer;
+		timer.Capture();
+
+		//the folders stand in for the build targets
+		fastl::vector<U32> unitFolders(numUnits);
+		for (U32 i = 0u, sz = static_cast<U32>(folders.size()); i < sz; ++i)
+		{
+			for (const U32 unitId : folders[i].unitIds)
+			{
+				unitFolders[unitId] = i;
+			}
+		}
+
+		fastl::vector<U32> signatures;
+		Utils::BuildSignatures(signatures, scoreData);
+
+		fastl::vector<Utils::UnityEdge> edges;
+		Utils::FindCandidates(edges, signatures, unitFolders);
+
+		auto estimateSimilarity = [&](const size_t index)
+		{
+			edges[index].similarity = Utils::GetSimilarity(signatures, edges[index].unitA, edges[index].unitB);
+		};
+		Threading::ParallelFor("Unity Similarity", edges.size(), estimateSimilarity);
+
+		fastl::sort(edges.begin(), edges.end(), [](const Utils::UnityEdge& a, const Utils::UnityEdge& b)
+		{
+			return a.similarity > b.similarity || (a.similarity == b.similarity && (a.unitA < b.unitA || (a.unitA == b.unitA && a.unitB < b.unitB)));
+		});
+
+		//greedy single linkage from the most similar pairs, under the size cap
+		fastl::vector<U32> parents(numUnits);
+		fastl::vector<U32> sizes(numUnits);
+		for (U32 i = 0u; i < numUnits; ++i)
+		{
+			parents[i] = i;
+			sizes[i] = 1u;
+		}
+
+		for (const Utils::UnityEdge& edge : edges)
+		{
+			if (edge.similarity < Utils::MIN_UNITY_SIMILARITY) break;
+
+			U32 rootA = Utils::FindRoot(parents, edge.unitA);
+			U32 rootB = Utils::FindRoot(parents, edge.unitB);
+			if (rootA != rootB && sizes[rootA] + sizes[rootB] <= maxGroupUnits)
+			{
+				if (rootB < rootA)
+				{
+					const U32 swap = rootA;
+					rootA = rootB;
+					rootB = swap;
+				}
+				parents[rootB] = rootA;
+				sizes[rootA] += sizes[rootB];
+			}
+		}
+
+		//the root is the lowest unit of each group, so it is always found first
+		fastl::vector<U32> groupIds(numUnits);
+		fastl::vector<Utils::UnityGroup> groups;
+		for (U32 unitId = 0u; unitId < numUnits; ++unitId)
+		{
+			groupIds[unitId] = InvalidCompileId;
+		}
+
+		for (U32 unitId = 0u; unitId < numUnits; ++unitId)
+		{
+			const U32 root = Utils::FindRoot(parents, unitId);
+			if (sizes[root] < 2u) continue;
+
+			if (groupIds[root] == InvalidCompileId)
+			{
+				groupIds[root] = static_cast<U32>(groups.size());
+				groups.emplace_back();
+				groups.back().folderId = unitFolders[root];
+				groups.back().saved = 0u;
+				groups.back().frontEnd = 0u;
+			}
+
+			groupIds[unitId] = groupIds[root];
+			Utils::UnityGroup& group = groups[groupIds[unitId]];
+			group.unitIds.push_back(unitId);
+			group.frontEnd += units[unitId].values[ToUnderlying(CompileCategory::FrontEnd)];
+		}
+
+		//every header shared inside a group is parsed only once
+		fastl::vector<U32> lastIncludes(groups.size());
+		for (U32& lastInclude : lastIncludes)
+		{
+			lastInclude = InvalidCompileId;
+		}
+		for (U32 includeId = 0u, sz = static_cast<U32>(scoreData.includeCosts.size()); includeId < sz; ++includeId)
+		{
+			const CompileData& data = includeData[includeId];
+			const U64 cost = data.count ? data.selfAccumulated / data.count : 0u;
+			if (cost == 0u) continue;
+
+			Utils::ForEachUnit(scoreData.includeCosts[includeId].units, numUnits, [&](const U32 unitId)
+			{
+				const U32 groupId = groupIds[unitId];
+				if (groupId == InvalidCompileId) return;
+
+				if (lastIncludes[groupId] == includeId)
+				{
+					groups[groupId].saved += cost;
+				}
+				lastIncludes[groupId] = includeId;
+			});
+		}
+
+		fastl::sort(groups.begin(), groups.end(), [](const Utils::UnityGroup& a, const Utils::UnityGroup& b)
+		{
+			return a.saved > b.saved || (a.saved == b.saved && a.unitIds[0] < b.unitIds[0]);
+		});
+
+		timer.Capture();
+		LOG_INFO("Found %u unity groups from %u candidate pairs", static_cast<U32>(groups.size()), static_cast<U32>(edges.size()));
+		IO::LogTime(IO::Verbosity::Info, "Unity Grouping Time: ", timer.GetElapsed());
+		LOG_INFO("");
+
+		//report
+		U32 numGrouped = 0u;
+		U64 totalSaved = 0u;
+		U64 totalFrontEnd = 0u;
+		for (const Utils::UnityGroup& group : groups)
+		{
+			numGrouped += static_cast<U32>(group.unitIds.size());
+			totalSaved += group.saved;
+			totalFrontEnd += group.frontEnd;
+		}
+
+		stream.AppendFormat("\nGroups: %u covering %u of %u units, %.1f ms saved of %.1f ms frontend\n", static_cast<U32>(groups.size()), numGrouped, numUnits,
+			Utils::ToMs(static_cast<double>(totalSaved)), Utils::ToMs(static_cast<double>(totalFrontEnd)));
+
+		fastl::vector<U32> folderParents;
+		ScoreUtils::GetFolderParents(folderParents, folders);
+
+		const size_t numGroups = Utils::Min<size_t>(groups.size(), Utils::REPORT_MAX_GROUPS);
+		for (size_t i = 0u; i < numGroups; ++i)
+		{
+			const Utils::UnityGroup& group = groups[i];
+			stream.AppendFormat("\n%s ( %u units ): %.1f ms saved of %.1f ms frontend\n\n", Utils::GetGroupName(folders, folderParents, group.folderId).c_str(), 
+				static_cast<U32>(group.unitIds.size()), Utils::ToMs(static_cast<double>(group.saved)), Utils::ToMs(static_cast<double>(group.frontEnd)));
+
+			const size_t numGroupUnits = Utils::Min<size_t>(group.unitIds.size(), Utils::REPORT_MAX_UNITS);
+			for (size_t j = 0u; j < numGroupUnits; ++j)
+			{
+				TCompileStrings::const_iterator found = scoreData.strings.find(units[group.unitIds[j]].nameHash);
+				stream.AppendFormat("  %s\n", found == scoreData.strings.end() ? "?" : found->second.c_str());
+			}
+
+			if (numGroupUnits < group.unitIds.size())
+			{
+				stream.AppendFormat("  ... %u more\n", static_cast<U32>(group.unitIds.size() - numGroupUnits));
+			}
+		}
+
+		if (numGroups < groups.size())
+		{
+			stream.AppendFormat("\n... %u more groups\n", static_cast<U32>(groups.size() - numGroups));
+		}
+
+		return true;
+	}
+}
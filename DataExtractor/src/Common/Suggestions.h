@@ -0,0 +1,12 @@
+#pragma once
+
+// Build setup suggestions derived from the include data of the extracted units
+// The unity groups compare MinHash sketches of the transitive include set of each unit, bucketed with LSH to avoid any pairwise comparison
+
+struct ScoreData;
+
+namespace Suggestions
+{
+	bool WritePCHReport(const ScoreData& scoreData, unsigned int budget, const char* filename); //budget in ms of header parse time per PCH
+	bool WriteUnityReport(const ScoreData& scoreData, unsigned int maxGroupUnits, const char* filename);
+}
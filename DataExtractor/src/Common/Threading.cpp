@@ -0,0 +1,170 @@
+#include "Threading.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Profiler.h"
+
+namespace Threading
+{ 
+	namespace Utils
+	{ 
+		// -----------------------------------------------------------------------------------------------------------
+		struct Job
+		{ 
+			const char*         name;
+			TTaskFunc           func;
+			void*               context;
+			size_t              count;
+			std::atomic<size_t> nextIndex{0u};
+		};
+
+		// -----------------------------------------------------------------------------------------------------------
+		void RunTasks(Job& job)
+		{ 
+			size_t i = job.nextIndex.fetch_add(1u);
+			if (i >= job.count)
+			{ 
+				return;
+			}
+
+			//one zone per worker and job, the tasks can be too small to be recorded individually
+			PROFILE_ZONE(job.name);
+			for (; i < job.count; i = job.nextIndex.fetch_add(1u))
+			{ 
+				job.func(job.context, i);
+			}
+		}
+
+		thread_local bool t_isPoolWorker = false;
+
+		// -----------------------------------------------------------------------------------------------------------
+		// The worker threads live for the whole process, every thread keeps its thread local data between jobs
+		class WorkerPool
+		{ 
+		public:
+			explicit WorkerPool(const size_t numThreads)
+			{ 
+				threads.reserve(numThreads);
+				for (size_t i = 0u; i < numThreads; ++i)
+				{ 
+					threads.emplace_back([this](){ WorkerLoop(); });
+				}
+			}
+
+			~WorkerPool()
+			{ 
+				{ 
+					std::lock_guard<std::mutex> lock(mutex);
+					exiting = true;
+				}
+				wakeCondition.notify_all();
+
+				for (std::thread& thread : threads)
+				{ 
+					thread.join();
+				}
+			}
+
+			void Run(Job& job)
+			{ 
+				{ 
+					std::lock_guard<std::mutex> lock(mutex);
+					current = &job;
+					pendingWorkers = threads.size();
+					++generation;
+				}
+				wakeCondition.notify_all();
+
+				//the calling thread works as one of the workers, its nested loops must run inline too
+				t_isPoolWorker = true;
+				RunTasks(job);
+				t_isPoolWorker = false;
+
+				std::unique_lock<std::mutex> lock(mutex);
+				doneCondition.wait(lock, [this](){ return pendingWorkers == 0u; });
+				current = nullptr;
+			}
+
+		private:
+			void WorkerLoop()
+			{ 
+				t_isPoolWorker = true;
+
+				size_t lastGeneration = 0u;
+				for (;;)
+				{ 
+					Job* job = nullptr;
+					{ 
+						std::unique_lock<std::mutex> lock(mutex);
+						wakeCondition.wait(lock, [&](){ return exiting || generation != lastGeneration; });
+						if (exiting)
+						{ 
+							return;
+						}
+						lastGeneration = generation;
+						job = current;
+					}
+
+					RunTasks(*job);
+
+					bool isLast = false;
+					{ 
+						std::lock_guard<std::mutex> lock(mutex);
+						isLast = --pendingWorkers == 0u;
+					}
+
+					if (isLast)
+					{ 
+						doneCondition.notify_one();
+					}
+				}
+			}
+
+			std::mutex               mutex;
+			std::condition_variable  wakeCondition;
+			std::condition_variable  doneCondition;
+			std::vector<std::thread> threads;
+			Job*                     current = nullptr;
+			size_t                   pendingWorkers = 0u;
+			size_t                   generation = 0u;
+			bool                     exiting = false;
+		};
+
+		// -----------------------------------------------------------------------------------------------------------
+		WorkerPool& GetWorkerPool()
+		{ 
+			static WorkerPool pool(GetNumWorkers() - 1u);
+			return pool;
+		}
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	size_t GetNumWorkers()
+	{ 
+		const size_t hardwareThreads = std::thread::hardware_concurrency();
+		return hardwareThreads > 0u ? hardwareThreads : 1u;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	void ParallelFor(const char* name, size_t count, TTaskFunc func, void* context)
+	{ 
+		Utils::Job job;
+		job.name    = name;
+		job.func    = func;
+		job.context = context;
+		job.count   = count;
+
+		//nested loops run inline, the pool workers are busy with the outer one
+		if (count <= 1u || GetNumWorkers() <= 1u || Utils::t_isPoolWorker)
+		{ 
+			Utils::RunTasks(job);
+			return;
+		}
+
+		Utils::GetWorkerPool().Run(job);
+	}
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace Threading
+{ 
+	using TTaskFunc = void(*)(void* context, size_t index);
+
+	size_t GetNumWorkers();
+
+	// Executes func(context, i) for every i in [0, count) spread across the worker threads, returns when all are done
+	// The workers are reused between calls, each one records a single self trace zone with the given name per call
+	void ParallelFor(const char* name, size_t count, TTaskFunc func, void* context);
+
+	// -----------------------------------------------------------------------------------------------------------
+	template<typename TFunc> void ParallelFor(const char* name, size_t count, TFunc& func)
+	{ 
+		ParallelFor(name, count, [](void* context, size_t index){ (*static_cast<TFunc*>(context))(index); }, &func);
+	}
+}
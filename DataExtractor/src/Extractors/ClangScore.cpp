@@ -1,14 +1,18 @@
 #include "ClangScore.h"
 
+#include <atomic>
+
 #include "../Common/CommandLine.h"
 #include "../Common/Context.h"
 #include "../Common/CRC64.h"
 #include "../Common/DirectoryUtils.h"
 #include "../Common/JsonParser.h"
 #include "../Common/IOStream.h"
+#include "../Common/Profiler.h"
 #include "../Common/ScoreDefinitions.h"
 #include "../Common/ScoreProcessor.h"
 #include "../Common/StringUtils.h"
+#include "../Common/Threading.h"
 
 #include "../fastl/algorithm.h"
 
@@ -16,6 +20,7 @@ namespace Clang
 { 
 	constexpr int FAILURE = -1;
 	constexpr int SUCCESS = 0;
+	constexpr U64 TRACE_HEADER_SIZE = 512u;
 
 	namespace Utils
 	{ 
@@ -149,7 +154,7 @@ namespace Clang
 	};
 
 	// -----------------------------------------------------------------------------------------------------------
-	ProcessEventPhase ProcessEvent(ScoreData& scoreData, CompileEvent& output, CompileUnitContext& context, Json::Reader& reader, fastl::vector<CompileEvent>& pendingStack )
+	ProcessEventPhase ProcessEvent(ScoreData& scoreData, CompileEvent& output, CompileUnitContext& context, Json::Reader& reader, TCompileEvents& pendingStack, const CompileScore::EventFilter& filter )
 	{ 
 		constexpr static Json::Token tagName     = Utils::CreateLiteralToken("name");
 		constexpr static Json::Token tagStart    = Utils::CreateLiteralToken("ts");
@@ -170,7 +175,7 @@ namespace Clang
 			{
 				if (!reader.NextToken(token) || token.type != Json::Token::Type::String) return ProcessEventPhase::Failure;
 				output.category = ToCompileCategory(token);
-				if (output.nameHash == 0ull) output.nameHash = CompileScore::StoreCategoryTagString(scoreData,token.str,token.length, output.category);
+				if (output.nameHash == 0ull && filter.KeepName(output.category)) output.nameHash = CompileScore::StoreCategoryTagString(scoreData,token.str,token.length, output.category);
 			}
 			else if (Utils::EqualTokens(token,tagStart))
 			{
@@ -193,7 +198,7 @@ namespace Clang
 					{ 
 						if (!reader.NextToken(token) || token.type != Json::Token::Type::String) return ProcessEventPhase::Failure;
 
-						if( output.category < CompileCategory::GatherFull )
+						if( (output.category < CompileCategory::GatherFull || output.category == CompileCategory::RunPass) && filter.KeepName(output.category) )
 						{
 							output.nameHash = CompileScore::StoreCategoryValueString(scoreData,token.str,token.length, output.category);
 						}
@@ -235,8 +240,6 @@ namespace Clang
 			}
 		}
 
-		//TODO ~ ramonv ~ demangle optimize function names
-
 		//Process Start/End events
 		if ( phase == ProcessEventPhase::Start )
 		{
@@ -288,7 +291,7 @@ namespace Clang
 		const U8 track = GetTrack(compileEvent);
 
 		//Make sure we have the track ready for this upcoming event 
-		while( track >= timeline.tracks.size() ) { timeline.tracks.emplace_back(); }
+		while( track >= timeline.tracks.size() ) { timeline.tracks.emplace_back(timeline.tracks.get_allocator()); }
 
 		//inject in a sorted position
 		TCompileEvents& events = timeline.tracks[ track ]; 
@@ -351,12 +354,29 @@ namespace Clang
 		return true;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------
+	bool IsClangTraceFile(const char* path)
+	{
+		//Only sniff the beginning of the file, there is no need to load non trace jsons just to reject them
+		char header[TRACE_HEADER_SIZE];
+		if (!IO::ReadTextFileHeader(path, header, TRACE_HEADER_SIZE)) return false;
+
+		Json::Reader reader(header);
+		return CheckClangTraceJson(reader);
+	}
+
 	// -----------------------------------------------------------------------------------------------------------
 	bool ProcessFile(ScoreData& scoreData, const char* path, const char* content)
 	{ 
+		PROFILE_ZONE("Tokenize");
+
+		//All per file data lives in the scratch arena, released at once when leaving
+		fastl::Arena& arena = CompileScore::GetScratchArena();
+		fastl::ArenaScope scratchScope(arena);
+
 		CompileUnitContext context;
 
-		ScoreTimeline timeline;
+		ScoreTimeline timeline(&arena);
 
 		fastl::string inputPath{path};
 		StringUtils::NormalizePath(inputPath);
@@ -372,7 +392,10 @@ namespace Clang
 		Json::Token token; 
 		if (!reader.NextToken(token) || token.type != Json::Token::Type::ArrayOpen)  return false;
 		
-		fastl::vector<CompileEvent> pendingEventStack;
+		TCompileEvents pendingEventStack(&arena);
+
+		//Drop as early as possible everything this export is not going to use
+		const CompileScore::EventFilter filter;
 
 		while (reader.NextToken(token) && token.type != Json::Token::Type::ArrayClose)
 		{ 
@@ -380,7 +403,7 @@ namespace Clang
 			if (token.type != Json::Token::Type::ObjectOpen) 
 				return false;
 
-			const ProcessEventPhase processResult = ProcessEvent( scoreData, compileEvent, context, reader, pendingEventStack );
+			const ProcessEventPhase processResult = ProcessEvent( scoreData, compileEvent, context, reader, pendingEventStack, filter );
 
 			if ( processResult == ProcessEventPhase::Failure ) 
 				return false;
@@ -397,7 +420,7 @@ namespace Clang
 				context.startTime[1] = compileEvent.start;
 			}
 
-			if (compileEvent.category != CompileCategory::Invalid)
+			if (compileEvent.category != CompileCategory::Invalid && filter.KeepEvent(compileEvent.category))
 			{ 
 				AddEventToTimeline(timeline,compileEvent);
 			}
@@ -417,19 +440,88 @@ namespace Clang
 	}
 
 	// -----------------------------------------------------------------------------------------------------------
-	bool ProcessFile(ScoreData& scoreData, const char* path)
+	// The path was already sniffed as a clang trace, this is the only full read of the file
+	bool ProcessTraceFile(ScoreData& scoreData, const char* path)
 	{ 
-		if (IO::FileTextBuffer fileBuffer = IO::ReadTextFile(path))
+		IO::FileTextBuffer fileBuffer = nullptr;
 		{ 
-			ProcessFile(scoreData,path,fileBuffer);
+			PROFILE_ZONE("Read File");
+			fileBuffer = IO::ReadTextFile(path);
+		}
+
+		if (fileBuffer)
+		{ 
+			const bool processed = ProcessFile(scoreData,path,fileBuffer);
 			IO::DestroyBuffer(fileBuffer);
-			return true;
+			return processed;
 		}
 		 
 		LOG_ERROR("Invalid file buffer for %s", path);
 		return false;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------
+	bool ProcessFile(ScoreData& scoreData, const char* path)
+	{ 
+		if (!IsClangTraceFile(path))
+		{ 
+			LOG_INFO("Skipping non trace file %s", path);
+			return false;
+		}
+
+		return ProcessTraceFile(scoreData,path);
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool IsSampledFile(const ExportParams& params, const char* root, const char* path)
+	{ 
+		//hash the path relative to the input root so the same files get picked wherever the build lives
+		const size_t rootLength = Utils::StrLength(root);
+		const size_t pathLength = Utils::StrLength(path);
+		size_t prefixLength = pathLength >= rootLength && Utils::Impl::EqualStr(path, root, rootLength) ? rootLength : 0u;
+		for (; prefixLength < pathLength && (path[prefixLength] == '/' || path[prefixLength] == '\\'); ++prefixLength){}
+		return Hash::AppendToCRC64(0ull, path + prefixLength, pathLength - prefixLength) % 100u < params.samplePercent;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	bool ProcessSampledFile(ScoreData& scoreData, const ExportParams& params, const char* root, const char* path)
+	{ 
+		if (params.samplePercent >= 100u)
+		{ 
+			return ProcessFile(scoreData,path);
+		}
+
+		//only the traces are part of the population, the sampled ones that fail to parse are left out of it as well
+		if (!IsClangTraceFile(path))
+		{ 
+			LOG_INFO("Skipping non trace file %s", path);
+			return false;
+		}
+
+		if (!IsSampledFile(params,root,path))
+		{ 
+			++scoreData.session.totalFiles;
+			return false;
+		}
+
+		const bool processed = ProcessTraceFile(scoreData,path);
+		if (processed)
+		{ 
+			++scoreData.session.totalFiles;
+			++scoreData.session.sampledFiles;
+		}
+		return processed;
+	}
+
+	// -----------------------------------------------------------------------------------------------------------
+	void LogSampling(const ScoreData& scoreData)
+	{ 
+		if (scoreData.session.IsSampled())
+		{ 
+			LOG_PROGRESS("Sampled %u of %u files, the totals are extrapolated.", scoreData.session.sampledFiles, scoreData.session.totalFiles);
+		}
+	}
+
 	//////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 	// -----------------------------------------------------------------------------------------------------------
@@ -506,6 +598,36 @@ namespace Clang
 		return true;
 	}
 
+	// -----------------------------------------------------------------------------------------------------------
+	// Folder shared by all the paths of a .ctl list, the sampling hashes the paths relative to it
+	fastl::string GetCommonFolder(const char* list)
+	{ 
+		const char* first = nullptr;
+		size_t length = 0u;
+
+		for (const char* line = list; *line != '\0';)
+		{ 
+			if (*line != '\n')
+			{ 
+				if (first == nullptr)
+				{ 
+					first = line;
+					for (; first[length] != '\n' && first[length] != '\0'; ++length){}
+				}
+
+				size_t match = 0u;
+				for (; match < length && line[match] == first[match]; ++match){}
+				length = match;
+			}
+
+			while (*line != '\n' && *line != '\0') ++line;
+			if (*line == '\n') ++line;
+		}
+
+		while (length > 0u && first[length - 1] != '/' && first[length - 1] != '\\') --length;
+		return length > 0u? fastl::string(first, length) : fastl::string();
+	}
+
 	// -----------------------------------------------------------------------------------------------------------
 	int GenerateScoreTrace(const ExportParams& params)
 	{
@@ -519,6 +641,7 @@ namespace Clang
 
 		Context::Scoped<IO::ScoreBinarizer> binarizer(params.output,params.timelinePacking);
 
+		const fastl::string root = GetCommonFolder(fileBuffer);
 		const char* pathStart = fileBuffer;
 
 		while(*fileBuffer)
@@ -529,7 +652,7 @@ namespace Clang
 				
 				if (pathStart < fileBuffer)
 				{ 
-					ProcessFile(scoreData,pathStart);
+					ProcessSampledFile(scoreData,params,root.c_str(),pathStart);
 				}
 
 				pathStart = ++fileBuffer;
@@ -542,8 +665,9 @@ namespace Clang
 
 		if (pathStart < fileBuffer)
 		{ 
-			ProcessFile(scoreData,pathStart);
+			ProcessSampledFile(scoreData,params,root.c_str(),pathStart);
 		}
+		LogSampling(scoreData);
 
 		CompileScore::FinalizeScoreData(scoreData);
 		binarizer.Get().Binarize(scoreData);
@@ -565,18 +689,13 @@ namespace Clang
 		while (const char* path = dirScan.SeekNext())
 		{ 
 			++filesFound;
-			if (IO::FileTextBuffer fileBuffer = IO::ReadTextFile(path))
+			if (ProcessSampledFile(scoreData,params,params.input,path))
 			{ 
-				ProcessFile(scoreData,path,fileBuffer);
-				IO::DestroyBuffer(fileBuffer);
+				LOG_INFO("Parsed file %u: (%s)\n",filesFound, path);
 			}
-			else
-			{ 
-				LOG_ERROR("Invalid file buffer for %s", path);
-			}
-			LOG_INFO("Parsed file %u: (%s)\n",filesFound, path);
 		}
 		LOG_PROGRESS("Found %u files.\n",filesFound);
+		LogSampling(scoreData);
 
 		CompileScore::FinalizeScoreData(scoreData);
 		binarizer.Get().Binarize(scoreData);
@@ -589,29 +708,27 @@ namespace Clang
 	{
 		LOG_PROGRESS("Scanning dir: %s", params.input);
 
-		size_t filesFound = 0u;
+		fastl::vector<fastl::string> candidates;
 		IO::DirectoryScanner dirScan(params.input, ".json");
 		while (const char* path = dirScan.SeekNext())
 		{
-			if (IO::FileTextBuffer fileBuffer = IO::ReadTextFile(path))
-			{
-				//Read the first bits and validate we are reading a clang trace
-				Json::Reader reader(fileBuffer);
-				if (CheckClangTraceJson(reader)) 
-				{
-					IO::DeleteFile(path);
-					++filesFound;
-					LOG_INFO("Removed file %u: (%s)\n", filesFound, path);
-				}
-				IO::DestroyBuffer(fileBuffer);
-			}
-			else
+			candidates.emplace_back(path);
+		}
+
+		//Sniff and delete in parallel, we are bound by the file system operations here
+		std::atomic<size_t> filesRemoved{0u};
+		auto cleanFile = [&](size_t index)
+		{ 
+			const char* path = candidates[index].c_str();
+			if (IsClangTraceFile(path) && IO::DeleteFile(path))
 			{
-				LOG_ERROR("Invalid file buffer for %s", path);
+				++filesRemoved;
+				IO::Log(IO::Verbosity::Info, "Removed file: (%s)\n", path);
 			}
-		}
+		};
+		Threading::ParallelFor("Clean Files", candidates.size(), cleanFile);
 
-		LOG_PROGRESS("Removed %u files.\n",filesFound);
+		LOG_PROGRESS("Removed %u files.\n",static_cast<U32>(filesRemoved.load()));
 
 		return SUCCESS;
 	}
@@ -2,6 +2,8 @@
 
 #ifdef USE_FASTL
 
+#include "vector.h"
+
 namespace fastl 
 { 
     //------------------------------------------------------------------------------------------
@@ -74,6 +76,88 @@ namespace fastl
     {
         return lower_bound(first, last, value, [=](const T& lhs, const T& rhs) { return lhs < rhs; });
     }
+
+    namespace Impl
+    { 
+        //------------------------------------------------------------------------------------------
+        template<class Iterator> void IterSwap(Iterator a, Iterator b)
+        { 
+            auto tmp = move(*a);
+            *a = move(*b);
+            *b = move(tmp);
+        }
+
+        //------------------------------------------------------------------------------------------
+        template<class Iterator, class Compare>
+        void InsertionSort(Iterator first, Iterator last, Compare comp)
+        { 
+            for (Iterator i = first + 1; i < last; ++i)
+            { 
+                for (Iterator k = i; k > first && comp(*k, *(k - 1)); --k)
+                { 
+                    IterSwap(k, k - 1);
+                }
+            }
+        }
+    }
+
+    //------------------------------------------------------------------------------------------
+    template<class Iterator, class Compare>
+    void sort(Iterator first, Iterator last, Compare comp)
+    { 
+        //specific implementation for continous memory ( vectors ) 
+        //quicksort with median of three pivots, recursing on the smaller side keeps the stack bounded
+        constexpr size_t insertionThreshold = 16;
+        while (static_cast<size_t>(last - first) > insertionThreshold)
+        { 
+            Iterator middle = first + (last - first) / 2;
+            Iterator back = last - 1;
+            if (comp(*middle, *first)) Impl::IterSwap(middle, first);
+            if (comp(*back, *middle))
+            { 
+                Impl::IterSwap(back, middle);
+                if (comp(*middle, *first)) Impl::IterSwap(middle, first);
+            }
+
+            //keep the pivot out of the way at the end
+            Impl::IterSwap(middle, back - 1);
+            Iterator pivot = back - 1;
+
+            Iterator i = first;
+            Iterator k = pivot;
+            for (;;)
+            { 
+                while (comp(*++i, *pivot)) {}
+                while (comp(*pivot, *--k)) {}
+                if (i >= k) break;
+                Impl::IterSwap(i, k);
+            }
+            Impl::IterSwap(i, pivot);
+
+            if (i - first < last - (i + 1))
+            { 
+                sort(first, i, comp);
+                first = i + 1;
+            }
+            else
+            { 
+                sort(i + 1, last, comp);
+                last = i;
+            }
+        }
+
+        if (last - first > 1)
+        { 
+            Impl::InsertionSort(first, last, comp);
+        }
+    }
+
+    //------------------------------------------------------------------------------------------
+    template<class Iterator>
+    void sort(Iterator first, Iterator last)
+    {
+        sort(first, last, [](const auto& lhs, const auto& rhs) { return lhs < rhs; });
+    }
 }
 
 #else 
@@ -90,6 +174,9 @@ namespace fastl
 
     template<class Iterator, class T> Iterator lower_bound(Iterator first, Iterator last, const T& value) { return std::lower_bound(first, last, value); }
     template<class Iterator, class T, class Compare> Iterator lower_bound(Iterator first, Iterator last, const T& value, Compare comp) { return std::lower_bound(first, last, value, comp);  }
+
+    template<class Iterator> inline void sort(Iterator first, Iterator last) { std::sort(first, last); }
+    template<class Iterator, class Compare> inline void sort(Iterator first, Iterator last, Compare comp) { std::sort(first, last, comp); }
 } 
 
 #endif //USE_FASTL
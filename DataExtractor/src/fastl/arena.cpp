@@ -0,0 +1,58 @@
+#include "arena.h"
+
+namespace fastl
+{
+	//------------------------------------------------------------------------------------------
+	Arena::Arena(const size_t chunkSize)
+		: m_head(nullptr)
+		, m_current(nullptr)
+		, m_offset(0u)
+		, m_chunkSize(chunkSize)
+	{ 
+	}
+
+	//------------------------------------------------------------------------------------------
+	Arena::~Arena()
+	{ 
+		while (m_head)
+		{ 
+			Chunk* next = m_head->next;
+			delete[] reinterpret_cast<char*>(m_head);
+			m_head = next;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------
+	void* Arena::Allocate(const size_t size, const size_t alignment)
+	{ 
+		if (m_current)
+		{ 
+			const size_t alignedOffset = (m_offset + alignment - 1u) & ~(alignment - 1u);
+			if (alignedOffset + size <= m_current->capacity)
+			{ 
+				m_offset = alignedOffset + size;
+				return GetChunkData(m_current) + alignedOffset;
+			}
+		}
+
+		//Move to the next chunk, reusing the ones left behind by a rewind when they are big enough
+		Chunk* next = m_current? m_current->next : m_head;
+		if (next == nullptr || next->capacity < size)
+		{ 
+			const size_t capacity = size > m_chunkSize? size : m_chunkSize;
+			Chunk* chunk = reinterpret_cast<Chunk*>(new char[sizeof(Chunk) + capacity]);
+			chunk->capacity = capacity;
+			chunk->next = next;
+
+			if (m_current) m_current->next = chunk;
+			else m_head = chunk;
+
+			next = chunk;
+		}
+
+		//chunk data starts aligned to the chunk header, which covers any alignment we need
+		m_current = next;
+		m_offset = size;
+		return GetChunkData(m_current);
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifndef USE_FASTL
+#include <type_traits>
+#endif //USE_FASTL
+
+namespace fastl
+{
+	////////////////////////////////////////////////////////////////////////////////////////////
+	// Bump allocator for short lived data, individual allocations are never freed 
+	// The memory is given back all at once by rewinding to a marker, chunks are kept around for reuse
+	class Arena
+	{ 
+	private: 
+		enum { DEFAULT_CHUNK_SIZE = 256*1024 };
+
+		struct Chunk
+		{ 
+			Chunk* next; 
+			size_t capacity;
+		};
+
+	public:
+		struct Marker
+		{ 
+			Chunk* chunk; 
+			size_t offset;
+		};
+
+	public: 
+		explicit Arena(const size_t chunkSize = DEFAULT_CHUNK_SIZE);
+		~Arena();
+
+		Arena(const Arena& input) = delete;
+		Arena(Arena&& input) = delete;
+		Arena& operator = (const Arena& input) = delete;
+		Arena& operator = (Arena&& input) = delete;
+
+		void* Allocate(const size_t size, const size_t alignment);
+
+		Marker GetMarker() const { return Marker{ m_current, m_offset }; }
+		void Rewind(const Marker& marker) { m_current = marker.chunk; m_offset = marker.offset; }
+		void Reset() { m_current = nullptr; m_offset = 0u; }
+
+	private: 
+		static char* GetChunkData(Chunk* chunk) { return reinterpret_cast<char*>(chunk + 1); }
+
+	private: 
+		Chunk* m_head; 
+		Chunk* m_current; 
+		size_t m_offset;
+		size_t m_chunkSize;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////
+	// Rewinds the arena to its current position when going out of scope
+	class ArenaScope
+	{ 
+	public: 
+		explicit ArenaScope(Arena& arena) : m_arena(arena), m_marker(arena.GetMarker()) {}
+		~ArenaScope() { m_arena.Rewind(m_marker); }
+
+		ArenaScope(const ArenaScope& input) = delete;
+		ArenaScope& operator = (const ArenaScope& input) = delete;
+
+	private: 
+		Arena&        m_arena;
+		Arena::Marker m_marker;
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////
+	// Container allocator bound to an arena, falls back to the heap when no arena is given
+	template<typename T> class ArenaAllocator
+	{ 
+	public:
+		typedef T value_type;
+
+#ifndef USE_FASTL
+		typedef std::true_type propagate_on_container_copy_assignment;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+#endif //USE_FASTL
+
+	public:
+		ArenaAllocator() : m_arena(nullptr) {}
+		ArenaAllocator(Arena* arena) : m_arena(arena) {}
+		ArenaAllocator(Arena& arena) : m_arena(&arena) {}
+		template<typename U> ArenaAllocator(const ArenaAllocator<U>& input) : m_arena(input.GetArena()) {}
+
+		T* allocate(const size_t count) 
+		{ 
+			return m_arena? static_cast<T*>(m_arena->Allocate(count*sizeof(T), alignof(T))) : reinterpret_cast<T*>(new char[count*sizeof(T)]);
+		}
+
+		void deallocate(T* buffer, const size_t) 
+		{ 
+			if (m_arena == nullptr) delete[] reinterpret_cast<char*>(buffer);
+		}
+
+		Arena* GetArena() const { return m_arena; }
+
+		template<typename U> bool operator == (const ArenaAllocator<U>& input) const { return m_arena == input.GetArena(); }
+		template<typename U> bool operator != (const ArenaAllocator<U>& input) const { return m_arena != input.GetArena(); }
+
+	private: 
+		Arena* m_arena;
+	};
+}
@@ -0,0 +1,362 @@
+#pragma once
+
+#ifdef USE_FASTL
+
+#include "vector.h"
+#include "pair.h"
+
+namespace fastl
+{
+	//------------------------------------------------------------------------------------------
+	// The keys used across the tool are either CRC64 hashes or dense ids, both spread well enough as they are
+	template<typename TKey> struct hash
+	{
+		size_t operator()(const TKey& key) const { return static_cast<size_t>(key); }
+	};
+
+	//------------------------------------------------------------------------------------------
+	template<typename T> void Swap(T& a, T& b)
+	{
+		T tmp = move(a);
+		a = move(b);
+		b = move(tmp);
+	}
+
+	////////////////////////////////////////////////////////////////////////////////////////////
+	// Flat open addressing table with robin hood probing and backward shift deletion
+	// TKeyOf extracts the key from a stored entry ( maps store pairs, sets store the keys directly )
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher = hash<TKey>>
+	class HashTable
+	{
+	private:
+		typedef unsigned char TDistance; //0 means empty slot, otherwise probe distance + 1
+
+		enum
+		{
+			MIN_CAPACITY = 16,
+			MAX_DISTANCE = 255,
+		};
+
+		template<typename TTable, typename TValue> class Iterator
+		{
+		public:
+			Iterator(TTable* table, size_t index) : m_table(table), m_index(index) { SkipEmpty(); }
+			template<typename TInputTable, typename TInputValue> Iterator(const Iterator<TInputTable, TInputValue>& input) : m_table(input.GetTable()), m_index(input.GetIndex()) {}
+
+			TValue& operator*() const { return m_table->m_entries[m_index]; }
+			TValue* operator->() const { return &m_table->m_entries[m_index]; }
+			Iterator& operator++() { ++m_index; SkipEmpty(); return *this; }
+
+			bool operator == (const Iterator& input) const { return m_index == input.m_index; }
+			bool operator != (const Iterator& input) const { return m_index != input.m_index; }
+
+			TTable* GetTable() const { return m_table; }
+			size_t GetIndex() const { return m_index; }
+
+		private:
+			void SkipEmpty() { while (m_index < m_table->m_capacity && m_table->m_distances[m_index] == 0u) ++m_index; }
+
+		private:
+			TTable* m_table;
+			size_t  m_index;
+		};
+
+	public:
+		typedef TEntry                                 value_type;
+		typedef size_t                                 size_type;
+		typedef Iterator<HashTable, TEntry>            iterator;
+		typedef Iterator<const HashTable, const TEntry> const_iterator;
+
+	public:
+		HashTable();
+		HashTable(const HashTable& input);
+		HashTable(HashTable&& input);
+		~HashTable();
+
+		HashTable& operator = (const HashTable& input);
+		HashTable& operator = (HashTable&& input);
+
+		iterator begin() { return iterator(this, 0u); }
+		const_iterator begin() const { return const_iterator(this, 0u); }
+		iterator end() { return iterator(this, m_capacity); }
+		const_iterator end() const { return const_iterator(this, m_capacity); }
+
+		bool empty() const { return m_size == 0u; }
+		size_type size() const { return m_size; }
+
+		void clear();
+		void reserve(const size_type size);
+
+		pair<iterator, bool> insert(value_type&& value);
+		pair<iterator, bool> insert(const value_type& value) { return insert(value_type(value)); }
+
+		iterator find(const TKey& key) { return iterator(this, FindIndex(key)); }
+		const_iterator find(const TKey& key) const { return const_iterator(this, FindIndex(key)); }
+
+		void erase(iterator it) { EraseIndex(it.GetIndex()); }
+		size_type erase(const TKey& key);
+
+	private:
+		size_t GetHomeIndex(const TKey& key) const { return THasher()(key) & (m_capacity - 1u); }
+		size_t FindIndex(const TKey& key) const;
+		size_t InsertUnique(value_type&& value);
+		void   EraseIndex(size_t index);
+		void   Rehash(const size_t capacity);
+		void   Destroy();
+
+	private:
+		TEntry*    m_entries;
+		TDistance* m_distances;
+		size_t     m_size;
+		size_t     m_capacity;
+	};
+
+	// Implementation
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> HashTable<TKey,TEntry,TKeyOf,THasher>::HashTable()
+		: m_entries(nullptr)
+		, m_distances(nullptr)
+		, m_size(0u)
+		, m_capacity(0u)
+	{
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> HashTable<TKey,TEntry,TKeyOf,THasher>::HashTable(const HashTable& input)
+		: HashTable()
+	{
+		*this = input;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> HashTable<TKey,TEntry,TKeyOf,THasher>::HashTable(HashTable&& input)
+		: m_entries(input.m_entries)
+		, m_distances(input.m_distances)
+		, m_size(input.m_size)
+		, m_capacity(input.m_capacity)
+	{
+		input.m_entries = nullptr;
+		input.m_distances = nullptr;
+		input.m_size = 0u;
+		input.m_capacity = 0u;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> HashTable<TKey,TEntry,TKeyOf,THasher>::~HashTable()
+	{
+		Destroy();
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> HashTable<TKey,TEntry,TKeyOf,THasher>& HashTable<TKey,TEntry,TKeyOf,THasher>::operator = (const HashTable& input)
+	{
+		if (this != &input)
+		{
+			clear();
+			reserve(input.m_size);
+			for (const TEntry& entry : input)
+			{
+				InsertUnique(TEntry(entry));
+			}
+		}
+		return *this;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> HashTable<TKey,TEntry,TKeyOf,THasher>& HashTable<TKey,TEntry,TKeyOf,THasher>::operator = (HashTable&& input)
+	{
+		if (this != &input)
+		{
+			Destroy();
+			m_entries = input.m_entries;
+			m_distances = input.m_distances;
+			m_size = input.m_size;
+			m_capacity = input.m_capacity;
+			input.m_entries = nullptr;
+			input.m_distances = nullptr;
+			input.m_size = 0u;
+			input.m_capacity = 0u;
+		}
+		return *this;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> void HashTable<TKey,TEntry,TKeyOf,THasher>::clear()
+	{
+		for (size_t i = 0u; i < m_capacity; ++i)
+		{
+			if (m_distances[i])
+			{
+				m_entries[i].~TEntry();
+				m_distances[i] = 0u;
+			}
+		}
+		m_size = 0u;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> void HashTable<TKey,TEntry,TKeyOf,THasher>::reserve(const size_type size)
+	{
+		//keep the load factor under 3/4
+		size_t capacity = m_capacity? m_capacity : MIN_CAPACITY;
+		while (size*4u > capacity*3u) capacity *= 2u;
+
+		if (capacity > m_capacity)
+		{
+			Rehash(capacity);
+		}
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> pair<typename HashTable<TKey,TEntry,TKeyOf,THasher>::iterator,bool> HashTable<TKey,TEntry,TKeyOf,THasher>::insert(value_type&& value)
+	{
+		const size_t found = FindIndex(TKeyOf()(value));
+		if (found != m_capacity)
+		{
+			return pair<iterator,bool>(iterator(this, found), false);
+		}
+
+		reserve(m_size + 1u);
+		return pair<iterator,bool>(iterator(this, InsertUnique(move(value))), true);
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> typename HashTable<TKey,TEntry,TKeyOf,THasher>::size_type HashTable<TKey,TEntry,TKeyOf,THasher>::erase(const TKey& key)
+	{
+		const size_t found = FindIndex(key);
+		if (found != m_capacity)
+		{
+			EraseIndex(found);
+			return 1u;
+		}
+		return 0u;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> size_t HashTable<TKey,TEntry,TKeyOf,THasher>::FindIndex(const TKey& key) const
+	{
+		if (m_size == 0u)
+		{
+			return m_capacity;
+		}
+
+		const size_t mask = m_capacity - 1u;
+		size_t index = GetHomeIndex(key);
+
+		//robin hood invariant: once we reach an entry closer to its home than we are, the key is not in the table
+		for (TDistance distance = 1u; m_distances[index] >= distance; ++distance, index = (index + 1u) & mask)
+		{
+			if (m_distances[index] == distance && TKeyOf()(m_entries[index]) == key)
+			{
+				return index;
+			}
+		}
+
+		return m_capacity;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> size_t HashTable<TKey,TEntry,TKeyOf,THasher>::InsertUnique(value_type&& value)
+	{
+		//Assumes the key is not present and there is room for it
+		const TKey key = TKeyOf()(value);
+		const size_t mask = m_capacity - 1u;
+		size_t index = GetHomeIndex(key);
+		size_t insertedIndex = m_capacity;
+		TDistance distance = 1u;
+
+		TEntry carry = move(value);
+		for(;;)
+		{
+			if (m_distances[index] == 0u)
+			{
+				Construct<TEntry>(&m_entries[index], move(carry));
+				m_distances[index] = distance;
+				++m_size;
+				return insertedIndex == m_capacity? index : insertedIndex;
+			}
+
+			if (m_distances[index] < distance)
+			{
+				//steal the slot from the richer entry and keep looking for a place for it
+				Swap(carry, m_entries[index]);
+				Swap(distance, m_distances[index]);
+				insertedIndex = insertedIndex == m_capacity? index : insertedIndex;
+			}
+
+			if (distance == MAX_DISTANCE)
+			{
+				//degenerate clustering, grow and start over with the entry we are carrying
+				Rehash(m_capacity * 2u);
+				InsertUnique(move(carry));
+				return FindIndex(key);
+			}
+
+			++distance;
+			index = (index + 1u) & mask;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> void HashTable<TKey,TEntry,TKeyOf,THasher>::EraseIndex(size_t index)
+	{
+		//shift back the following entries of the same cluster to keep the probe sequences compact
+		const size_t mask = m_capacity - 1u;
+		size_t next = (index + 1u) & mask;
+		while (m_distances[next] > 1u)
+		{
+			m_entries[index] = move(m_entries[next]);
+			m_distances[index] = m_distances[next] - 1u;
+			index = next;
+			next = (next + 1u) & mask;
+		}
+
+		m_entries[index].~TEntry();
+		m_distances[index] = 0u;
+		--m_size;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> void HashTable<TKey,TEntry,TKeyOf,THasher>::Rehash(const size_t capacity)
+	{
+		TEntry*    oldEntries   = m_entries;
+		TDistance* oldDistances = m_distances;
+		const size_t oldCapacity = m_capacity;
+
+		m_entries   = reinterpret_cast<TEntry*>(new char[capacity*sizeof(TEntry)]);
+		m_distances = new TDistance[capacity];
+		m_capacity  = capacity;
+		m_size      = 0u;
+
+		for (size_t i = 0u; i < capacity; ++i)
+		{
+			m_distances[i] = 0u;
+		}
+
+		for (size_t i = 0u; i < oldCapacity; ++i)
+		{
+			if (oldDistances[i])
+			{
+				InsertUnique(move(oldEntries[i]));
+				oldEntries[i].~TEntry();
+			}
+		}
+
+		delete[] reinterpret_cast<char*>(oldEntries);
+		delete[] oldDistances;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TEntry, typename TKeyOf, typename THasher> void HashTable<TKey,TEntry,TKeyOf,THasher>::Destroy()
+	{
+		clear();
+		delete[] reinterpret_cast<char*>(m_entries);
+		delete[] m_distances;
+		m_entries = nullptr;
+		m_distances = nullptr;
+		m_capacity = 0u;
+	}
+}
+
+#endif //USE_FASTL
@@ -2,7 +2,7 @@
 
 #ifdef USE_FASTL
 
-#include "vector.h"
+#include <stddef.h>
 
 namespace fastl
 {
@@ -25,48 +25,58 @@ namespace fastl
 	}
 
 	////////////////////////////////////////////////////////////////////////////////////////////
-	// Build string as a vector<char>
+	// Build string with small string optimization, short strings live inside the object itself
 	template<typename TChar>
 	class StringImpl
 	{
-	private:
-		typedef vector<TChar> TData;
 	public:
 		typedef TChar value_type;
-		typedef typename TData::size_type size_type;
+		typedef size_t size_type;
 
 		static constexpr size_type npos = -1;
+
+	private:
+		enum { LOCAL_CAPACITY = 24/sizeof(TChar) - 1 }; //in characters, not counting the terminator
+
 	public:
 		StringImpl();
 		StringImpl(const char* input);
 		StringImpl(const char* input, const size_type length);
+		StringImpl(const StringImpl<TChar>& input);
+		StringImpl(StringImpl<TChar>&& input);
+		~StringImpl();
+
+		StringImpl<TChar>& operator = (const StringImpl<TChar>& input);
+		StringImpl<TChar>& operator = (StringImpl<TChar>&& input);
 
 		void clear();
 
-		bool empty() const { return size() == 0u; }
-		size_type size() const { return m_data.empty() ? 0 : m_data.size() - 1; }
-		size_type length() const { return size(); }
+		bool empty() const { return m_size == 0u; }
+		size_type size() const { return m_size; }
+		size_type length() const { return m_size; }
+		size_type capacity() const { return IsLocal()? LOCAL_CAPACITY : m_capacity; }
 
-		value_type* begin() { return m_data.begin(); }
-		const value_type* begin() const { return m_data.begin(); }
-		value_type* end() { return m_data.end() - 1; }
-		const value_type* end() const { return m_data.end() - 1; }
+		value_type* begin() { return m_data; }
+		const value_type* begin() const { return m_data; }
+		value_type* end() { return m_data + m_size; }
+		const value_type* end() const { return m_data + m_size; }
 
-		const value_type* c_str() const { return m_data.begin(); }
+		const value_type* c_str() const { return m_data; }
 
 		value_type& operator[](size_type index) { return m_data[index]; }
 		value_type  operator[](size_type index) const { return m_data[index]; }
 
-		StringImpl& erase( size_type index){ m_data.erase(m_data.begin()+index); return *this; }
-		StringImpl& erase( size_type index, size_type count){ m_data.erase(m_data.begin()+index,m_data.begin()+index+count); return *this; }
+		StringImpl& erase( size_type index){ return erase(index,1u); }
+		StringImpl& erase( size_type index, size_type count);
 
-		void append( const char* str );
+		void reserve(const size_type size);
+		void append( const char* str ) { Append(str,ComputeStrLen(str)); }
 
 		StringImpl<TChar> operator+(const char c);
 		StringImpl<TChar> operator+(const char* str);
 		StringImpl<TChar> operator+(const StringImpl<TChar>& str);
 
-		void operator += (const char c) { m_data.insert(m_data.end()-1,c); }
+		void operator += (const char c) { Append(&c,1u); }
 		void operator += (const char* str) { Append(str,ComputeStrLen(str)); }
 		void operator += (const StringImpl<TChar>& str) { Append(str.c_str(), str.size()); }
 
@@ -81,45 +91,127 @@ namespace fastl
 		bool operator >  (const StringImpl<TChar>& str) const { return *this > str.c_str(); }
 
 	private: 
+		bool IsLocal() const { return m_data == m_local; }
 		void Append(const char* str, const size_type appendSize);
+		void Release();
+		void Steal(StringImpl<TChar>& input);
 
 	private: 
-		TData m_data;
+		value_type* m_data;
+		size_type   m_size;
+		union 
+		{ 
+			size_type  m_capacity;
+			value_type m_local[LOCAL_CAPACITY + 1];
+		};
 	};
 
 	//Implementation
 
 	//------------------------------------------------------------------------------------------
 	template<typename TChar> StringImpl<TChar>::StringImpl()
+		: m_data(m_local)
+		, m_size(0u)
 	{ 
-		clear();
+		m_local[0] = '\0';
 	}
 
 	//------------------------------------------------------------------------------------------
 	template<typename TChar> StringImpl<TChar>::StringImpl(const char* input)
+		: StringImpl()
 	{ 
-		clear(); 
 		Append(input, ComputeStrLen(input));
 	}
 
 	//------------------------------------------------------------------------------------------
 	template<typename TChar> StringImpl<TChar>::StringImpl(const char* input, const size_type length)
+		: StringImpl()
 	{ 
-		clear();
 		Append(input, length);
 	}
 
+	//------------------------------------------------------------------------------------------
+	template<typename TChar> StringImpl<TChar>::StringImpl(const StringImpl<TChar>& input)
+		: StringImpl()
+	{ 
+		*this = input;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TChar> StringImpl<TChar>::StringImpl(StringImpl<TChar>&& input)
+		: StringImpl()
+	{ 
+		Steal(input);
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TChar> StringImpl<TChar>::~StringImpl()
+	{ 
+		Release();
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TChar> StringImpl<TChar>& StringImpl<TChar>::operator = (const StringImpl<TChar>& input)
+	{ 
+		if (this != &input)
+		{ 
+			reserve(input.m_size);
+			for (size_type i = 0; i <= input.m_size; ++i) 
+			{ 
+				m_data[i] = input.m_data[i];
+			}
+			m_size = input.m_size;
+		}
+		return *this;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TChar> StringImpl<TChar>& StringImpl<TChar>::operator = (StringImpl<TChar>&& input)
+	{ 
+		if (this != &input)
+		{ 
+			Release();
+			Steal(input);
+		}
+		return *this;
+	}
+
 	//------------------------------------------------------------------------------------------
 	template<typename TChar> inline void StringImpl<TChar>::clear() 
 	{ 
-		m_data.resize(1); 
+		m_size = 0u;
 		m_data[0] = '\0'; 
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename TChar> void StringImpl<TChar>::append( const char* str )
-	{
-		*this = *this + str;
+	template<typename TChar> StringImpl<TChar>& StringImpl<TChar>::erase(size_type index, size_type count)
+	{ 
+		//shift the tail including the terminator
+		for (size_type i = index + count; i <= m_size; ++i)
+		{ 
+			m_data[i - count] = m_data[i];
+		}
+		m_size -= count;
+		return *this;
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TChar> void StringImpl<TChar>::reserve(const size_type size)
+	{ 
+		const size_type currentCapacity = capacity();
+		if (size > currentCapacity)
+		{ 
+			const size_type newCapacity = size > 2u*currentCapacity ? size : 2u*currentCapacity;
+			value_type* newData = new value_type[newCapacity + 1u];
+			for (size_type i = 0; i <= m_size; ++i)
+			{ 
+				newData[i] = m_data[i];
+			}
+
+			Release();
+			m_data = newData;
+			m_capacity = newCapacity;
+		}
 	}
 
 	//------------------------------------------------------------------------------------------
@@ -148,15 +240,48 @@ namespace fastl
 	//------------------------------------------------------------------------------------------
 	template<typename TChar> void StringImpl<TChar>::Append(const char* str, const size_type appendSize)
 	{ 
-		size_type writeIndex = size();
-		m_data.resize(m_data.size()+appendSize);
-		for (size_type i = 0; i < appendSize; ++i, ++writeIndex)
+		reserve(m_size + appendSize);
+		for (size_type i = 0; i < appendSize; ++i)
 		{
-			m_data[writeIndex] = str[i];
+			m_data[m_size + i] = str[i];
 		}
-		m_data.back() = '\0';
+		m_size += appendSize;
+		m_data[m_size] = '\0';
 	}	
 
+	//------------------------------------------------------------------------------------------
+	template<typename TChar> void StringImpl<TChar>::Release()
+	{ 
+		if (!IsLocal())
+		{ 
+			delete[] m_data;
+			m_data = m_local;
+		}
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename TChar> void StringImpl<TChar>::Steal(StringImpl<TChar>& input)
+	{ 
+		//Assumes this string is empty and local
+		if (input.IsLocal())
+		{ 
+			for (size_type i = 0; i <= input.m_size; ++i)
+			{ 
+				m_local[i] = input.m_local[i];
+			}
+		}
+		else
+		{ 
+			m_data = input.m_data;
+			m_capacity = input.m_capacity;
+			input.m_data = input.m_local;
+		}
+
+		m_size = input.m_size;
+		input.m_size = 0u;
+		input.m_local[0] = '\0';
+	}
+
 	using string = StringImpl<char>;
 	using wstring = StringImpl<wchar_t>;
 }
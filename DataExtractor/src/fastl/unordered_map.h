@@ -2,12 +2,41 @@
 
 #ifdef USE_FASTL
 
-#include "map.h"
+#include "hash_table.h"
 
 namespace fastl
 {
-	// Build unordered_map as a map 
-	template<typename TKey, typename TValue> using unordered_map = fastl::map<TKey, TValue>;
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TValue> struct MapKeyOf
+	{ 
+		const TKey& operator()(const pair<TKey, TValue>& entry) const { return entry.first; }
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////
+	// Build unordered_map as a flat hash table of pairs
+	template<typename TKey, typename TValue>
+	class unordered_map : public HashTable<TKey, pair<TKey, TValue>, MapKeyOf<TKey, TValue>>
+	{
+	private: 
+		typedef HashTable<TKey, pair<TKey, TValue>, MapKeyOf<TKey, TValue>> TBase;
+
+	public: 
+		typedef typename TBase::value_type value_type;
+		typedef typename TBase::iterator   iterator;
+
+	public:
+		TValue& operator[](const TKey& key);
+		template<typename ... Args> pair<iterator, bool> emplace(Args&&... args) { return TBase::insert(value_type(args...)); }
+	};
+
+	// Implementation
+
+	//------------------------------------------------------------------------------------------
+	template<typename TKey, typename TValue> TValue& unordered_map<TKey,TValue>::operator[](const TKey& key)
+	{ 
+		iterator found = TBase::find(key);
+		return found != TBase::end()? found->second : TBase::insert(value_type(key, TValue())).first->second;
+	}
 }
 
 #else 
@@ -2,12 +2,30 @@
 
 #ifdef USE_FASTL
 
-#include "set.h"
+#include "hash_table.h"
 
 namespace fastl
 {
-	// Build unordered_map as a map 
-	template<typename TKey> using unordered_set = fastl::set<TKey>;
+	//------------------------------------------------------------------------------------------
+	template<typename TKey> struct SetKeyOf
+	{ 
+		const TKey& operator()(const TKey& entry) const { return entry; }
+	};
+
+	////////////////////////////////////////////////////////////////////////////////////////////
+	// Build unordered_set as a flat hash table of keys
+	template<typename TKey>
+	class unordered_set : public HashTable<TKey, TKey, SetKeyOf<TKey>>
+	{
+	private: 
+		typedef HashTable<TKey, TKey, SetKeyOf<TKey>> TBase;
+
+	public: 
+		typedef typename TBase::iterator iterator;
+
+	public:
+		template<typename ... Args> pair<iterator, bool> emplace(Args&&... args) { return TBase::insert(TKey(args...)); }
+	};
 }
 
 #else 
@@ -20,17 +20,27 @@ namespace fastl
 
 	template<typename T, typename ... Args> void Construct(T* ptr, Args&&... args) { new (ptr) T(move(args)...); }
 
-	template<typename T> T* CreateBuffer(size_t size){ return (T*) new char[size*sizeof(T)]; }
-	template<typename T> void DestroyBuffer(T* buffer){ delete[] reinterpret_cast<char*>(buffer); }
+	////////////////////////////////////////////////////////////////////////////////////////////
+	template<typename T> struct allocator
+	{ 
+		typedef T value_type;
+
+		allocator(){}
+		template<typename U> allocator(const allocator<U>&){}
+
+		T* allocate(size_t size){ return (T*) new char[size*sizeof(T)]; }
+		void deallocate(T* buffer, size_t){ delete[] reinterpret_cast<char*>(buffer); }
+	};
 
 	////////////////////////////////////////////////////////////////////////////////////////////
-	template<typename T> class vector
+	template<typename T, typename TAllocator = allocator<T>> class vector : private TAllocator
 	{ 
 	private: 
 		enum { DEFAULT_CAPACITY_SIZE = 8 };
 	public:
-		typedef T        value_type;
-		typedef size_t   size_type;
+		typedef T          value_type;
+		typedef size_t     size_type;
+		typedef TAllocator allocator_type;
 
 		typedef T*       iterator;
 		typedef const T* const_iterator;
@@ -39,21 +49,24 @@ namespace fastl
 
 	public:
 		vector();
+		explicit vector(const TAllocator& alloc);
 		explicit vector(size_t size);
 
 		//If more than 1 argument is provided we assume that we want to construct the vector with its elements ( using SFINAE - fake initializer list )
 		template<typename ... Args, enable_if_t<(sizeof...(Args) > 1)>* = nullptr> 
-		vector(Args&&... args) : m_data(CreateBuffer<T>(sizeof...(Args))), m_size(0u), m_capacity(sizeof...(Args))
+		vector(Args&&... args) : m_data(TAllocator::allocate(sizeof...(Args))), m_size(0u), m_capacity(sizeof...(Args))
 		{ 
 			(emplace_back(args),...); 
 		}
 
-		vector(const vector<T>& input);
-		vector(vector<T>&& input);
+		vector(const vector& input);
+		vector(vector&& input);
 		~vector();
 
-		vector<T>& operator = (const vector<T>& t);
-		vector<T>& operator = (vector<T>&& t);
+		vector& operator = (const vector& t);
+		vector& operator = (vector&& t);
+
+		allocator_type get_allocator() const { return *this; }
 
 		reference operator[](size_type index) { return m_data[index]; }
 		const_reference operator[](size_type index) const { return m_data[index]; }
@@ -94,7 +107,7 @@ namespace fastl
 	//Implementation
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> vector<T>::vector()
+	template<typename T, typename TAllocator> vector<T,TAllocator>::vector()
 		: m_data(nullptr)
 		, m_size(0u)
 		, m_capacity(0u)
@@ -102,8 +115,17 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> vector<T>::vector(size_t size)
-		: m_data(CreateBuffer<T>(size))
+	template<typename T, typename TAllocator> vector<T,TAllocator>::vector(const TAllocator& alloc)
+		: TAllocator(alloc)
+		, m_data(nullptr)
+		, m_size(0u)
+		, m_capacity(0u)
+	{
+	}
+
+	//------------------------------------------------------------------------------------------
+	template<typename T, typename TAllocator> vector<T,TAllocator>::vector(size_t size)
+		: m_data(TAllocator::allocate(size))
 		, m_size(size)
 		, m_capacity(size)
 	{ 
@@ -115,8 +137,9 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> vector<T>::vector(const vector<T>& input)
-		: m_data(CreateBuffer<T>(input.m_capacity))
+	template<typename T, typename TAllocator> vector<T,TAllocator>::vector(const vector& input)
+		: TAllocator(input)
+		, m_data(TAllocator::allocate(input.m_capacity))
 		, m_size(input.m_size)
 		, m_capacity(input.m_capacity)
 	{
@@ -128,8 +151,9 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> vector<T>::vector(vector<T>&& input)
-		: m_data(move(input.m_data))
+	template<typename T, typename TAllocator> vector<T,TAllocator>::vector(vector&& input)
+		: TAllocator(input)
+		, m_data(move(input.m_data))
 		, m_size(move(input.m_size))
 		, m_capacity(move(input.m_capacity))
 	{ 
@@ -139,13 +163,13 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> vector<T>::~vector() 
+	template<typename T, typename TAllocator> vector<T,TAllocator>::~vector() 
 	{ 
 		Destroy();
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline vector<T>& vector<T>::operator= (const vector<T>& input)
+	template<typename T, typename TAllocator> inline vector<T,TAllocator>& vector<T,TAllocator>::operator= (const vector& input)
 	{
 		clear();
 		reserve(input.m_capacity);
@@ -158,11 +182,12 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> vector<T>& vector<T>::operator = (vector<T>&& t)
+	template<typename T, typename TAllocator> vector<T,TAllocator>& vector<T,TAllocator>::operator = (vector&& t)
 	{
 		if (this != &t) 
 		{ 
 			Destroy(); 
+			TAllocator::operator=(t);
 			m_data = move(t.m_data);
 			m_size = move(t.m_size); 
 			m_capacity = move(t.m_capacity);
@@ -174,12 +199,13 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline void vector<T>::reserve(const size_type size)
+	template<typename T, typename TAllocator> inline void vector<T,TAllocator>::reserve(const size_type size)
 	{
 		if (size > m_capacity)
 		{ 
+			const size_type oldCapacity = m_capacity;
 			m_capacity = size;
-			T* newData = CreateBuffer<T>(m_capacity);
+			T* newData = TAllocator::allocate(m_capacity);
 
 			for (size_type i = 0u; i < m_size; ++i)
 			{
@@ -187,14 +213,14 @@ namespace fastl
 				m_data[i].~T();
 			}
 
-			DestroyBuffer(m_data);
+			if (m_data) TAllocator::deallocate(m_data, oldCapacity);
 			m_data = newData;
 			
 		}
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline void vector<T>::resize(const size_type size)
+	template<typename T, typename TAllocator> inline void vector<T,TAllocator>::resize(const size_type size)
 	{
 		reserve(size);
 
@@ -212,31 +238,31 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline void vector<T>::clear()
+	template<typename T, typename TAllocator> inline void vector<T,TAllocator>::clear()
 	{
 		resize(0u);
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline void vector<T>::push_back(const value_type& value)
+	template<typename T, typename TAllocator> inline void vector<T,TAllocator>::push_back(const value_type& value)
 	{
 		emplace(end(), value);
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline typename vector<T>::iterator vector<T>::insert(iterator it,const value_type& value)
+	template<typename T, typename TAllocator> inline typename vector<T,TAllocator>::iterator vector<T,TAllocator>::insert(iterator it,const value_type& value)
 	{ 
 		return emplace(it, value);
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> template<typename ... Args> void vector<T>::emplace_back(Args&&... args)
+	template<typename T, typename TAllocator> template<typename ... Args> void vector<T,TAllocator>::emplace_back(Args&&... args)
 	{
 		emplace(end(),move(args)...);
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline void vector<T>::pop_back()
+	template<typename T, typename TAllocator> inline void vector<T,TAllocator>::pop_back()
 	{ 
 		if (!empty())
 		{ 
@@ -245,7 +271,7 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> template<typename ... Args> typename vector<T>::iterator vector<T>::emplace(iterator it, Args&&... args)
+	template<typename T, typename TAllocator> template<typename ... Args> typename vector<T,TAllocator>::iterator vector<T,TAllocator>::emplace(iterator it, Args&&... args)
 	{ 
 		const size_type index = it-begin();
 
@@ -281,13 +307,13 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline typename vector<T>::iterator vector<T>::erase(iterator it)
+	template<typename T, typename TAllocator> inline typename vector<T,TAllocator>::iterator vector<T,TAllocator>::erase(iterator it)
 	{ 
 		return erase(it,it+1);
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> inline typename vector<T>::iterator vector<T>::erase(iterator fromIt, iterator toIt)
+	template<typename T, typename TAllocator> inline typename vector<T,TAllocator>::iterator vector<T,TAllocator>::erase(iterator fromIt, iterator toIt)
 	{
 		const size_type rangeSize = toIt-fromIt;
 		const_iterator batchEndIt = end()-rangeSize;
@@ -302,14 +328,14 @@ namespace fastl
 	}
 
 	//------------------------------------------------------------------------------------------
-	template<typename T> void vector<T>::Destroy()
+	template<typename T, typename TAllocator> void vector<T,TAllocator>::Destroy()
 	{
 		for (size_type i=0u;i<m_size;++i)
 		{
 			m_data[i].~T();
 		}
 
-		DestroyBuffer(m_data);
+		if (m_data) TAllocator::deallocate(m_data, m_capacity);
 	}
 }
 
@@ -319,7 +345,8 @@ namespace fastl
 
 namespace fastl
 { 
-	template<typename T> using vector = std::vector<T>;
+	template<typename T> using allocator = std::allocator<T>;
+	template<typename T, typename TAllocator = allocator<T>> using vector = std::vector<T, TAllocator>;
 }
 
 #endif //USE_FASTL
@@ -327,6 +354,6 @@ namespace fastl
 
 #ifdef FASTL_EXPOSE_PLAIN_ALIAS
 
-template<typename T> using vector = fastl::vector<T>;
+template<typename T, typename TAllocator = fastl::allocator<T>> using vector = fastl::vector<T, TAllocator>;
 
 #endif //FASTL_EXPOSE_PLAIN_ALIAS
\ No newline at end of file
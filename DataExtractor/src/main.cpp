@@ -1,6 +1,7 @@
 #include "Common/CommandLine.h"
 #include "Common/Context.h"
 #include "Common/IOStream.h"
+#include "Common/Profiler.h"
 #include "Common/Timers.h"
 #include "Extractors/MSVCScore.h"
 #include "Extractors/ClangScore.h"
@@ -42,6 +43,18 @@ int main(int argc, char* argv[])
         return FAILURE;
     } 
 
+    if (params.Get().selfTrace)
+    { 
+        if (Profiler::IsAvailable())
+        { 
+            Profiler::Start();
+        }
+        else
+        { 
+            LOG_ERROR("Self tracing is not available in this build ( requires USE_PROFILER ).");
+        }
+    }
+
     //Execute exporter
     int result = FAILURE;
 
@@ -60,6 +73,11 @@ int main(int argc, char* argv[])
         return FAILURE;
     }
 
+    if (params.Get().selfTrace && Profiler::IsEnabled())
+    { 
+        Profiler::Stop(params.Get().selfTrace);
+    }
+
     timer.Capture();
     IO::LogTime(IO::Verbosity::Progress,"Execution Time: ",timer.GetElapsed());
 
@@ -0,0 +1,203 @@
+###########################
+# Benchmark Corpus        #
+###########################
+#
+# Scales the test project up to a large generated code base in order to get real compiler traces to benchmark the Data Extractor.
+#
+# The headers are laid out in BENCHMARK_HEADER_DEPTH layers of BENCHMARK_HEADERS files, each file includes BENCHMARK_INCLUDES
+# random headers from the next layer. Each translation unit includes BENCHMARK_INCLUDES headers from the top layer and instantiates
+# the templates they define. The random choices come from BENCHMARK_SEED so the same settings always generate the same code.
+#
+# Usage ( clang only, the traces come from -ftime-trace ):
+#   cmake -G Ninja -DCMAKE_CXX_COMPILER=clang++ -DBENCHMARK_UNITS=2000 -DSCORE_EXTRACTOR=<path to ScoreDataExtractor> <this folder>
+#   cmake --build . --target benchmark_extract
+
+set(BENCHMARK_UNITS          0   CACHE STRING "Number of generated translation units ( 0 disables the benchmark corpus )")
+set(BENCHMARK_HEADERS        32  CACHE STRING "Number of generated headers per include layer")
+set(BENCHMARK_HEADER_DEPTH   6   CACHE STRING "Number of generated include layers")
+set(BENCHMARK_INCLUDES       4   CACHE STRING "Number of includes per generated file")
+set(BENCHMARK_TEMPLATE_DEPTH 24  CACHE STRING "Recursion depth of the generated templates")
+set(BENCHMARK_SEED           1   CACHE STRING "Seed used for all random choices while generating the corpus")
+set(BENCHMARK_RUNS           5   CACHE STRING "Number of timed extractions")
+set(BENCHMARK_EXTRACT_ARGS   ""  CACHE STRING "Extra arguments for the timed extractions ( example: '-d 1 -nt' )")
+set(SCORE_EXTRACTOR          ""  CACHE FILEPATH "Path to the ScoreDataExtractor executable to benchmark")
+
+set(BENCHMARK_TARGET CompileScoreBenchmark)
+set(BENCHMARK_MODULE_DIR ${CMAKE_CURRENT_LIST_DIR})
+set(BENCHMARK_CODE_DIR ${CMAKE_CURRENT_BINARY_DIR}/benchmark/src)
+set(BENCHMARK_STD_HEADERS "vector" "map" "string" "tuple" "memory" "algorithm")
+
+#########
+# Utils #
+#########
+
+# Random number in [0, RANGE) from the seeded sequence
+function(BenchmarkRandom OUTPUT RANGE)
+	string(RANDOM LENGTH 6 ALPHABET "123456789" value) #no zeroes, math() would read a leading zero as octal
+	math(EXPR value "${value} % ${RANGE}")
+	set(${OUTPUT} ${value} PARENT_SCOPE)
+endfunction()
+
+# Only touch the files that actually changed so reconfiguring does not trigger a full rebuild
+function(BenchmarkWriteFile FILENAME CONTENT)
+	if(EXISTS ${FILENAME})
+		file(READ ${FILENAME} currentContent)
+		if("${currentContent}" STREQUAL "${CONTENT}")
+			return()
+		endif()
+	endif()
+	file(WRITE ${FILENAME} "${CONTENT}")
+endfunction()
+
+# Includes for a file that pulls from the given layer
+function(BenchmarkIncludes OUTPUT LAYER)
+	set(includes "")
+	foreach(i RANGE 1 ${BENCHMARK_INCLUDES})
+		BenchmarkRandom(index ${BENCHMARK_HEADERS})
+		string(APPEND includes "#include \"bench_${LAYER}_${index}.h\"\n")
+	endforeach()
+	set(${OUTPUT} "${includes}" PARENT_SCOPE)
+endfunction()
+
+function(BenchmarkGenerateHeader LAYER INDEX)
+	set(ns bench_${LAYER}_${INDEX})
+	set(content "#pragma once\n\n")
+
+	math(EXPR nextLayer "${LAYER} + 1")
+	if(nextLayer LESS BENCHMARK_HEADER_DEPTH)
+		BenchmarkIncludes(includes ${nextLayer})
+		string(APPEND content "${includes}")
+	else()
+		list(LENGTH BENCHMARK_STD_HEADERS numStdHeaders)
+		BenchmarkRandom(stdIndex ${numStdHeaders})
+		list(GET BENCHMARK_STD_HEADERS ${stdIndex} stdHeader)
+		string(APPEND content "#include <${stdHeader}>\n")
+	endif()
+	string(APPEND content "#include <vector>\n\n")
+
+	string(APPEND content
+"namespace ${ns}\n{\n"
+"	template<typename T, int N> struct Node\n"
+"	{\n"
+"		using Next = Node<T, N - 1>;\n"
+"		static constexpr int value = N + Next::value;\n"
+"		static T Build() { T result = Next::Build(); result += T(N); return result; }\n"
+"	};\n\n"
+"	template<typename T> struct Node<T, 0>\n"
+"	{\n"
+"		static constexpr int value = 0;\n"
+"		static T Build() { return T(0); }\n"
+"	};\n\n"
+"	template<typename T> class Container\n"
+"	{\n"
+"	public:\n"
+"		void Add(const T& value) { m_values.push_back(value); }\n"
+"		T Sum() const { T result = T(0); for (const T& value : m_values) { result += value; } return result; }\n\n"
+"		template<int N> void AddNode() { Add(Node<T, N>::Build()); }\n\n"
+"	private:\n"
+"		std::vector<T> m_values;\n"
+"	};\n\n"
+"	inline int Value() { return Node<int, ${BENCHMARK_TEMPLATE_DEPTH}>::value + ${INDEX}; }\n"
+"}\n")
+
+	BenchmarkWriteFile(${BENCHMARK_CODE_DIR}/bench_${LAYER}_${INDEX}.h "${content}")
+endfunction()
+
+function(BenchmarkGenerateUnit INDEX)
+	BenchmarkIncludes(includes 0)
+	set(content "${includes}\n")
+
+	string(APPEND content
+"namespace\n{\n"
+"	struct Payload\n"
+"	{\n"
+"		explicit Payload(int value) : a(value), b(static_cast<double>(value) * 0.5) {}\n"
+"		Payload& operator += (const Payload& input) { a += input.a; b += input.b; return *this; }\n\n"
+"		int    a;\n"
+"		double b;\n"
+"	};\n"
+"}\n\n"
+"int BenchmarkUnit${INDEX}()\n{\n"
+"	int result = 0;\n")
+
+	#Use the included headers with per unit template arguments so each unit has its own instantiations
+	string(REGEX MATCHALL "bench_0_[0-9]+" namespaces "${includes}")
+	list(REMOVE_DUPLICATES namespaces)
+	foreach(ns ${namespaces})
+		BenchmarkRandom(depth ${BENCHMARK_TEMPLATE_DEPTH})
+		math(EXPR depth "${depth} + 1")
+		string(APPEND content
+"	{\n"
+"		${ns}::Container<Payload> payloads;\n"
+"		payloads.AddNode<${depth}>();\n"
+"		${ns}::Container<long> values;\n"
+"		values.AddNode<${depth}>();\n"
+"		result += payloads.Sum().a + static_cast<int>(values.Sum()) + ${ns}::Value();\n"
+"	}\n")
+	endforeach()
+
+	string(APPEND content "	return result;\n}\n")
+
+	BenchmarkWriteFile(${BENCHMARK_CODE_DIR}/unit_${INDEX}.cpp "${content}")
+endfunction()
+
+##############
+# Generation #
+##############
+
+function(BenchmarkGenerateCorpus OUTPUT_SOURCES)
+	message(STATUS "Generating benchmark corpus: ${BENCHMARK_UNITS} units, ${BENCHMARK_HEADER_DEPTH}x${BENCHMARK_HEADERS} headers, seed ${BENCHMARK_SEED}")
+
+	#Seed once, all following requests continue the same sequence
+	string(RANDOM LENGTH 1 RANDOM_SEED ${BENCHMARK_SEED} unused)
+
+	math(EXPR lastLayer "${BENCHMARK_HEADER_DEPTH} - 1")
+	math(EXPR lastHeader "${BENCHMARK_HEADERS} - 1")
+	foreach(layer RANGE ${lastLayer})
+		foreach(index RANGE ${lastHeader})
+			BenchmarkGenerateHeader(${layer} ${index})
+		endforeach()
+	endforeach()
+
+	set(sources "")
+	math(EXPR lastUnit "${BENCHMARK_UNITS} - 1")
+	foreach(index RANGE ${lastUnit})
+		BenchmarkGenerateUnit(${index})
+		list(APPEND sources ${BENCHMARK_CODE_DIR}/unit_${index}.cpp)
+	endforeach()
+
+	set(${OUTPUT_SOURCES} ${sources} PARENT_SCOPE)
+endfunction()
+
+function(BenchmarkSetup)
+	if(NOT CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+		message(WARNING "The benchmark corpus needs clang in order to produce -ftime-trace data.")
+	endif()
+
+	BenchmarkGenerateCorpus(sources)
+
+	add_library(${BENCHMARK_TARGET} STATIC)
+	target_sources(${BENCHMARK_TARGET} PRIVATE ${sources})
+	BaseCompilerSetup(${BENCHMARK_TARGET})
+	target_include_directories(${BENCHMARK_TARGET} PRIVATE ${BENCHMARK_CODE_DIR})
+
+	#Times the extraction on the traces from the last build
+	if(SCORE_EXTRACTOR)
+		add_custom_target(benchmark_extract
+			COMMAND ${CMAKE_COMMAND}
+				-DEXTRACTOR=${SCORE_EXTRACTOR}
+				-DINPUT=${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/${BENCHMARK_TARGET}.dir
+				-DOUTPUT_DIR=${CMAKE_CURRENT_BINARY_DIR}/benchmark/score
+				-DRUNS=${BENCHMARK_RUNS}
+				-DREPORT=${CMAKE_CURRENT_BINARY_DIR}/benchmark/report.txt
+				"-DEXTRACT_ARGS=${BENCHMARK_EXTRACT_ARGS}"
+				"-DCORPUS=units ${BENCHMARK_UNITS} headers ${BENCHMARK_HEADER_DEPTH}x${BENCHMARK_HEADERS} includes ${BENCHMARK_INCLUDES} templates ${BENCHMARK_TEMPLATE_DEPTH} seed ${BENCHMARK_SEED}"
+				-P ${BENCHMARK_MODULE_DIR}/BenchmarkExtract.cmake
+			DEPENDS ${BENCHMARK_TARGET}
+			USES_TERMINAL
+			VERBATIM
+			COMMENT "Benchmarking the score extraction")
+	else()
+		message(STATUS "Set SCORE_EXTRACTOR to enable the benchmark_extract target.")
+	endif()
+endfunction()
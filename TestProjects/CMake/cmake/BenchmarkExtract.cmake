@@ -0,0 +1,116 @@
+###########################
+# Benchmark Extract       #
+###########################
+#
+# Script mode: times the Data Extractor over the benchmark corpus traces and records the output sizes
+#
+#   cmake -DEXTRACTOR=<exe> -DINPUT=<trace folder> -DOUTPUT_DIR=<folder> -DRUNS=<count> -DREPORT=<file> [-DCORPUS=<desc>] [-DEXTRACT_ARGS=<args>] -P BenchmarkExtract.cmake
+
+cmake_minimum_required(VERSION 3.23) # string(TIMESTAMP) microseconds
+
+foreach(var EXTRACTOR INPUT OUTPUT_DIR RUNS REPORT)
+	if(NOT DEFINED ${var})
+		message(FATAL_ERROR "Missing ${var} definition.")
+	endif()
+endforeach()
+
+#########
+# Utils #
+#########
+
+function(BenchmarkNow OUTPUT)
+	string(TIMESTAMP stamp "%s;%f" UTC) #a single read, separate ones could straddle a second boundary
+	list(GET stamp 0 seconds)
+	list(GET stamp 1 micros)
+	string(REGEX REPLACE "^0+([0-9])" "\\1" micros "${micros}") #math() would read a leading zero as octal
+	math(EXPR now "${seconds} * 1000000 + ${micros}")
+	set(${OUTPUT} ${now} PARENT_SCOPE)
+endfunction()
+
+function(BenchmarkFolderSize OUTPUT_FILES OUTPUT_COUNT OUTPUT_SIZE PATTERN)
+	file(GLOB_RECURSE files ${PATTERN})
+	set(size 0)
+	set(count 0)
+	foreach(file ${files})
+		file(SIZE ${file} fileSize)
+		math(EXPR size "${size} + ${fileSize}")
+		math(EXPR count "${count} + 1")
+	endforeach()
+	set(${OUTPUT_FILES} ${files} PARENT_SCOPE)
+	set(${OUTPUT_COUNT} ${count} PARENT_SCOPE)
+	set(${OUTPUT_SIZE} ${size} PARENT_SCOPE)
+endfunction()
+
+###########
+# Extract #
+###########
+
+separate_arguments(extraArgs NATIVE_COMMAND "${EXTRACT_ARGS}")
+set(scoreFile ${OUTPUT_DIR}/compileData.scor)
+
+BenchmarkFolderSize(traces traceCount traceSize ${INPUT}/*.json)
+if(traceCount EQUAL 0)
+	message(FATAL_ERROR "No traces found in ${INPUT}, the corpus needs to be built with clang.")
+endif()
+
+#the folder scan skips files older than its time threshold, an explicit list makes every run parse the same traces
+get_filename_component(reportDir ${REPORT} DIRECTORY)
+set(traceList ${reportDir}/traces.ctl)
+list(JOIN traces "\n" traceListContent)
+file(WRITE ${traceList} "${traceListContent}\n")
+
+set(timings "")
+foreach(run RANGE 1 ${RUNS})
+	file(REMOVE_RECURSE ${OUTPUT_DIR})
+	file(MAKE_DIRECTORY ${OUTPUT_DIR})
+
+	BenchmarkNow(start)
+	execute_process(COMMAND ${EXTRACTOR} -clang -extract -i ${traceList} -o ${scoreFile} -v 0 ${extraArgs} RESULT_VARIABLE result)
+	BenchmarkNow(end)
+
+	if(NOT result EQUAL 0)
+		message(FATAL_ERROR "Extraction failed with result ${result}.")
+	endif()
+
+	if(NOT EXISTS ${scoreFile})
+		message(FATAL_ERROR "Extraction produced no ${scoreFile}.")
+	endif()
+
+	math(EXPR elapsed "(${end} - ${start}) / 1000")
+	list(APPEND timings ${elapsed})
+	message(STATUS "Run ${run}: ${elapsed} ms")
+endforeach()
+
+list(SORT timings COMPARE NATURAL)
+list(GET timings 0 minTime)
+list(LENGTH timings numTimings)
+math(EXPR medianIndex "${numTimings} / 2")
+list(GET timings ${medianIndex} medianTime)
+
+##########
+# Report #
+##########
+
+set(report "")
+string(APPEND report "corpus            ${CORPUS}\n")
+string(APPEND report "extractor         ${EXTRACTOR}\n")
+string(APPEND report "args              ${EXTRACT_ARGS}\n")
+string(APPEND report "traces            ${traceCount}\n")
+string(APPEND report "traces_bytes      ${traceSize}\n")
+string(APPEND report "runs              ${RUNS}\n")
+string(APPEND report "time_min_ms       ${minTime}\n")
+string(APPEND report "time_median_ms    ${medianTime}\n")
+
+file(GLOB outputs ${scoreFile}*)
+list(SORT outputs)
+set(outputSize 0)
+foreach(output ${outputs})
+	file(SIZE ${output} size)
+	math(EXPR outputSize "${outputSize} + ${size}")
+	get_filename_component(name ${output} NAME)
+	string(APPEND report "output ${name} ${size}\n")
+endforeach()
+string(APPEND report "output_bytes      ${outputSize}\n")
+
+file(WRITE ${REPORT} "${report}")
+message("${report}")